@@ -1,16 +1,24 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "AVLTree.hpp"
+#include "OutputBuffer.hpp"
+#include "Snapshot.hpp"
 
 #define RST  "\x1B[0m"
 #define KRED  "\x1B[41m"
 #define KBLU  "\x1B[44m"
 
-template <typename T>
-void AVLTree<T>::delete_children(Node *&node)
+template <typename T, typename Compare>
+void AVLTree<T, Compare>::delete_children(Node *&node)
 {
     if (node->lchild)
         delete_children(node->lchild);
@@ -20,29 +28,34 @@ void AVLTree<T>::delete_children(Node *&node)
     delete node;
 }
 
-template <typename T>
-AVLTree<T>::~AVLTree()
+template <typename T, typename Compare>
+AVLTree<T, Compare>::AVLTree(const Compare &comp) : comp(comp)
+{
+}
+
+template <typename T, typename Compare>
+AVLTree<T, Compare>::~AVLTree()
 {
     if (root)
         delete_children(root);
 }
 
-template <typename T>
-inline auto AVLTree<T>::getParentToChildPointer(const AVLTree<T>::Node *child) -> AVLTree<T>::Node *&
+template <typename T, typename Compare>
+inline auto AVLTree<T, Compare>::getParentToChildPointer(const AVLTree<T, Compare>::Node *child) -> AVLTree<T, Compare>::Node *&
 {
     return (child == root ? root :
             (child->parent->lchild == child ? child->parent->lchild : child->parent->rchild));
 }
 
-template <typename T>
-inline auto AVLTree<T>::getParentToSiblingPointer(const AVLTree<T>::Node *child) -> AVLTree<T>::Node *&
+template <typename T, typename Compare>
+inline auto AVLTree<T, Compare>::getParentToSiblingPointer(const AVLTree<T, Compare>::Node *child) -> AVLTree<T, Compare>::Node *&
 {
     return (child->parent->lchild == child ? child->parent->rchild : child->parent->lchild);
 }
 
-template <typename T>
-template <typename AVLTree<T>::RotationDirection R>
-void AVLTree<T>::__rotate_template(AVLTree<T>::Node *node)
+template <typename T, typename Compare>
+template <typename AVLTree<T, Compare>::RotationDirection R>
+void AVLTree<T, Compare>::__rotate_template(AVLTree<T, Compare>::Node *node)
 {
     Node *parent = node->parent;
 
@@ -75,54 +88,291 @@ void AVLTree<T>::__rotate_template(AVLTree<T>::Node *node)
     node->fixHeight();
 }
 
-template <typename T>
-void AVLTree<T>::rotate_left(Node *node)
+template <typename T, typename Compare>
+void AVLTree<T, Compare>::swap_with_predecessor(Node *node, Node *predecessor)
+{
+    // Predecessor is the largest node of the left subtree, so it has no rchild
+    Node *predecessor_parent = predecessor->parent;
+    Node *predecessor_lchild = predecessor->lchild;
+
+    // Predecessor takes the place of the node
+    getParentToChildPointer(node) = predecessor;
+    predecessor->parent = node->parent;
+
+    predecessor->rchild = node->rchild;
+    predecessor->rchild->parent = predecessor;
+
+    if (predecessor_parent == node) {
+        predecessor->lchild = node;
+        node->parent = predecessor;
+    }
+    else {
+        predecessor->lchild = node->lchild;
+        predecessor->lchild->parent = predecessor;
+
+        predecessor_parent->rchild = node;
+        node->parent = predecessor_parent;
+    }
+
+    // Node takes the place of the predecessor
+    node->lchild = predecessor_lchild;
+    if (predecessor_lchild)
+        predecessor_lchild->parent = node;
+    node->rchild = nullptr;
+
+    std::swap(node->height, predecessor->height);
+}
+
+template <typename T, typename Compare>
+void AVLTree<T, Compare>::rotate_left(Node *node)
 {
     __rotate_template<RotationDirection::LEFT>(node);
 }
 
-template <typename T>
-void AVLTree<T>::rotate_right(Node *node)
+template <typename T, typename Compare>
+void AVLTree<T, Compare>::rotate_right(Node *node)
 {
     __rotate_template<RotationDirection::RIGHT>(node);
 }
 
-template <typename T>
-void AVLTree<T>::add(const T &value)
+template <typename T, typename Compare>
+auto AVLTree<T, Compare>::add(const T &value) -> Node *
 {
-    if (!root) {
-        Node *node = new Node();
-        node->value = value;
-        root = node;
-
-        return;
-    }
-
     // Binary search
     Node **search = &root;
-    Node *parent;
+    Node *parent = nullptr;
 
     while (*search) {
         parent = *search;
 
-        if (parent->value > value)
+        if (comp(value, parent->value))
             search = &parent->lchild;
         else
             search = &parent->rchild;
     }
 
+    Node *node = new Node(value);
+    link_node(node, parent, search);
+
+    return node;
+}
+
+template <typename T, typename Compare>
+auto AVLTree<T, Compare>::insert_hint(Node *hint, const T &value) -> Node *
+{
+    if (!hint || comp(value, hint->value))
+        return add(value);
+
+    Node **slot;
+
+    if (hint->rchild) {
+        // New node becomes lchild of the hint's successor
+        hint = hint->rchild;
+        while (hint->lchild)
+            hint = hint->lchild;
+
+        if (comp(hint->value, value))
+            return add(value);
+
+        slot = &hint->lchild;
+    }
+    else {
+        // Successor is the first ancestor having hint in its left subtree
+        if (hint != rightmost) {
+            Node *successor = hint;
+            while (successor->parent->rchild == successor)
+                successor = successor->parent;
+            successor = successor->parent;
+
+            if (comp(successor->value, value))
+                return add(value);
+        }
+
+        slot = &hint->rchild;
+    }
+
+    Node *node = new Node(value);
+    link_node(node, hint, slot);
+
+    return node;
+}
+
+template <typename T, typename Compare>
+auto AVLTree<T, Compare>::find(const T &value) const -> Node *
+{
+    return find_node(value);
+}
+
+template <typename T, typename Compare>
+void AVLTree<T, Compare>::erase(Node *node)
+{
+    if (!node)
+        throw std::runtime_error("Node is empty!");
+
+    remove_node(node);
+}
+
+template <typename T, typename Compare>
+template <typename K, typename F>
+void AVLTree<T, Compare>::find_many(const K *values, std::size_t count, F &&found) const
+{
+    const std::size_t group = 16;
+    Node *nodes[group];
+
+    for (std::size_t first = 0; first < count; first += group) {
+        std::size_t size = std::min(group, count - first);
+        std::size_t active = size;
+
+        for (std::size_t i = 0; i < size; i++)
+            nodes[i] = root;
+
+        if (!root) {
+            for (std::size_t i = 0; i < size; i++)
+                found(first + i, nullptr);
+            continue;
+        }
+
+        // Finished walks are marked with nullptr
+        while (active) {
+            for (std::size_t i = 0; i < size; i++) {
+                Node *node = nodes[i];
+                if (!node)
+                    continue;
+
+                const K &value = values[first + i];
+                Node *next;
+
+                if (comp(value, node->value))
+                    next = node->lchild;
+                else if (comp(node->value, value))
+                    next = node->rchild;
+                else {
+                    found(first + i, node);
+                    nodes[i] = nullptr;
+                    active--;
+                    continue;
+                }
+
+                if (!next) {
+                    found(first + i, nullptr);
+                    active--;
+                }
+                else
+                    __builtin_prefetch(next);
+
+                nodes[i] = next;
+            }
+        }
+    }
+}
+
+template <typename T, typename Compare>
+void AVLTree<T, Compare>::add_many(const T *values, std::size_t count)
+{
+    const std::size_t group = 16;
+
+    for (std::size_t first = 0; first < count; first += group) {
+        std::size_t size = std::min(group, count - first);
+
+        // Walk only brings the paths into cache, adding changes the tree
+        find_many(values + first, size, [](std::size_t, Node *) {});
+
+        for (std::size_t i = first; i < first + size; i++)
+            add(values[i]);
+    }
+}
+
+template <typename T, typename Compare>
+std::size_t AVLTree<T, Compare>::remove_many(const T *values, std::size_t count)
+{
+    const std::size_t group = 16;
+    std::size_t removed = 0;
+
+    for (std::size_t first = 0; first < count; first += group) {
+        std::size_t size = std::min(group, count - first);
+
+        find_many(values + first, size, [](std::size_t, Node *) {});
+
+        for (std::size_t i = first; i < first + size; i++)
+            removed += remove(values[i]);
+    }
+
+    return removed;
+}
+
+template <typename T, typename Compare>
+std::size_t AVLTree<T, Compare>::contains_many(const T *values, std::size_t count, bool *results) const
+{
+    std::size_t present = 0;
+
+    find_many(values, count, [&](std::size_t i, Node *node) {
+        results[i] = node;
+        present += node != nullptr;
+    });
+
+    return present;
+}
+
+template <typename T, typename Compare>
+template <typename K>
+auto AVLTree<T, Compare>::find_node(const K &key) const -> Node *
+{
+    // Binary search
+    Node *search = root;
+    while (search) {
+        if (comp(key, search->value))
+            search = search->lchild;
+        else if (comp(search->value, key))
+            search = search->rchild;
+        else
+            break;
+    }
+
+    return search;
+}
+
+template <typename T, typename Compare>
+template <typename K>
+auto AVLTree<T, Compare>::find_slot(const K &key, Node *&parent) -> Node **
+{
+    Node **search = &root;
+    parent = nullptr;
+
+    while (*search) {
+        if (comp(key, (*search)->value)) {
+            parent = *search;
+            search = &parent->lchild;
+        }
+        else if (comp((*search)->value, key)) {
+            parent = *search;
+            search = &parent->rchild;
+        }
+        else
+            break;
+    }
+
+    return search;
+}
+
+template <typename T, typename Compare>
+void AVLTree<T, Compare>::link_node(Node *node, Node *parent, Node **slot)
+{
     // Add new node to the tree
-    Node *node = new Node();
-    node->value = value;
     node->parent = parent;
+    *slot = node;
+
+    if (!parent || (parent == rightmost && slot == &parent->rchild))
+        rightmost = node;
 
-    *search = node;
+    if (node == root)
+        return;
 
     // Update height and rebalance if needed
     do {
         Node *heavyChild = node;
         node = node->parent;
         bool isLchild = node->lchild == heavyChild;
+        std::size_t height = node->height;
 
         node->fixHeight();
 
@@ -157,9 +407,14 @@ void AVLTree<T>::add(const T &value)
             else
                 rotate_left(heavyChild);
 
-            node = heavyChild;
+            // Rotation restores the height subtree had before insertion
+            break;
         }
 
+        // Ancestors aren't affected if height of the subtree didn't change
+        if (node->height == height)
+            break;
+
     } while (node != root);
 
 #ifndef NDEBUG
@@ -167,20 +422,33 @@ void AVLTree<T>::add(const T &value)
 #endif // !NDEBUG
 }
 
-template <typename T>
-bool AVLTree<T>::remove(const T &value)
+template <typename T, typename Compare>
+bool AVLTree<T, Compare>::remove(const T &value)
 {
-    Node *search = root;
-    while (search && search->value != value) {
-        if (search->value > value)
-            search = search->lchild;
-        else
-            search = search->rchild;
-    }
+    Node *node = find_node(value);
 
-    if (!search)
+    if (!node)
         return false;
 
+    remove_node(node);
+
+    return true;
+}
+
+template <typename T, typename Compare>
+void AVLTree<T, Compare>::remove_node(Node *search)
+{
+    // Largest node has no rchild, its predecessor is the largest lchild or the parent
+    if (search == rightmost) {
+        if (search->lchild) {
+            rightmost = search->lchild;
+            while (rightmost->rchild)
+                rightmost = rightmost->rchild;
+        }
+        else
+            rightmost = search->parent;
+    }
+
     auto children_count = (search->lchild ? 1 : 0) + (search->rchild ? 1 : 0);
 
     Node *nodeToBeRemoved = search;
@@ -192,17 +460,17 @@ bool AVLTree<T>::remove(const T &value)
         while (largest_lchild->rchild)
             largest_lchild = largest_lchild->rchild;
 
-        nodeToBeRemoved->value = largest_lchild->value;
-        nodeToBeRemoved = largest_lchild;
+        // Nodes are relinked so values are never copied or moved
+        swap_with_predecessor(nodeToBeRemoved, largest_lchild);
 
-        if (largest_lchild->lchild) {
-            largest_lchild->lchild->parent = largest_lchild->parent;
-            getParentToChildPointer(largest_lchild) = largest_lchild->lchild;
+        if (nodeToBeRemoved->lchild) {
+            nodeToBeRemoved->lchild->parent = nodeToBeRemoved->parent;
+            getParentToChildPointer(nodeToBeRemoved) = nodeToBeRemoved->lchild;
         }
         else
             getParentToChildPointer(nodeToBeRemoved) = nullptr;
 
-        search = largest_lchild->parent;
+        search = nodeToBeRemoved->parent;
     }
     else if (children_count == 1) {
         auto &child_pointer = getParentToChildPointer(nodeToBeRemoved);
@@ -217,9 +485,9 @@ bool AVLTree<T>::remove(const T &value)
 
     delete nodeToBeRemoved;
 
-    if (!root) {
-        goto out;
-    }
+    // Tree is empty
+    if (!root)
+        return;
 
     // Update height and rebalance if needed
     while (search) {
@@ -267,96 +535,204 @@ bool AVLTree<T>::remove(const T &value)
 
     root->fixHeight();
 
-out:
 #ifndef NDEBUG
     checkHeight(root);
 #endif // !NDEBUG
-
-    return true;
 }
 
-template <typename T>
-bool AVLTree<T>::contains(const T &value) const
+template <typename T, typename Compare>
+bool AVLTree<T, Compare>::contains(const T &value) const
 {
-    const Node *search = root;
-    while (search && search->value != value) {
-        if (search->value > value)
-            search = search->lchild;
-        else
-            search = search->rchild;
-    }
-
-    if (search)
-        return true;
+    return find_node(value);
+}
 
-    return false;
+template <typename T, typename Compare>
+void AVLTree<T, Compare>::print() const
+{
+    OutputBuffer output;
+    dump(output);
 }
 
-template <typename T>
-void AVLTree<T>::print() const
+template <typename T, typename Compare>
+void AVLTree<T, Compare>::dump(OutputBuffer &output, bool plain) const
 {
     if (!root)
         return;
 
-    std::queue<Node *> kolejka, kolejka2;
+    // Level is stored as its nodes with the number of empty places before each of them,
+    // empty places are printed as N without walking their empty subtrees
+    struct Entry
+    {
+        const Node *node;
+        std::size_t empty_before;
+    };
+
+    std::vector<Entry> level = { { root, 0 } }, next;
+    std::size_t width = 1, padding = 0;
+
+    while (!level.empty()) {
+        std::size_t position = 0, empty = 0;
+        next.clear();
+
+        for (const auto &entry : level) {
+            for (std::size_t i = 0; i < entry.empty_before; i++)
+                output.write("N ", 2);
+            position += entry.empty_before + 1;
+
+            const Node *node = entry.node;
+            const char *color = plain ? nullptr : node->getBalance() > 0 ? KRED :
+                node->getBalance() < 0 ? KBLU : nullptr;
+
+            if (color)
+                output.write(color, std::strlen(color));
+            output.writeValue(node->value);
+            if (color)
+                output.write(RST, std::strlen(RST));
+            output.put(' ');
+
+            empty += 2 * entry.empty_before;
+            if (node->lchild) {
+                next.push_back({ node->lchild, empty });
+                empty = 0;
+            }
+            else
+                empty++;
 
-    Node *empty = new Node();
+            if (node->rchild) {
+                next.push_back({ node->rchild, empty });
+                empty = 0;
+            }
+            else
+                empty++;
+        }
 
-    int pow = 1, cur_pow = 0;
+        padding = width - position;
+        for (std::size_t i = 0; i < padding; i++)
+            output.write("N ", 2);
+        output.put('\n');
 
-    kolejka.push(root);
-    kolejka2.push(root);
+        width *= 2;
+        level.swap(next);
+    }
 
-    while (!kolejka2.empty()) {
-        if (kolejka.front() == empty)
-            std::cout << "N";
-        else if (kolejka.front()->getBalance() > 0)
-            std::cout << KRED << kolejka.front()->value << RST;
-        else if (kolejka.front()->getBalance() < 0)
-            std::cout << KBLU << kolejka.front()->value << RST;
-        else
-            std::cout << kolejka.front()->value;
+    // Empty line follows only a tree that fills its last level up to the last node
+    if (padding == 0)
+        output.put('\n');
+}
 
-        std::cout << " ";
+template <typename T, typename Compare>
+void AVLTree<T, Compare>::save(const std::string &path) const
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot stores raw values");
 
-        if (++cur_pow == pow) {
-            std::cout << std::endl;
-            cur_pow = 0;
-            pow *= 2;
-        }
+    std::vector<T> values;
+    std::vector<std::uint8_t> shapes;
+    std::vector<Node *> stack;
 
-        if (kolejka.front()->lchild) {
-            kolejka.push(kolejka.front()->lchild);
-            kolejka2.push(kolejka.front()->lchild);
-        }
-        else
-            kolejka.push(empty);
+    if (root)
+        stack.push_back(root);
 
-        if (kolejka.front()->rchild) {
-            kolejka.push(kolejka.front()->rchild);
-            kolejka2.push(kolejka.front()->rchild);
-        }
-        else
-            kolejka.push(empty);
+    // Pre-order, right child is pushed first so the left subtree is visited next
+    while (!stack.empty()) {
+        Node *node = stack.back();
+        stack.pop_back();
+
+        values.push_back(node->value);
+        shapes.push_back((node->lchild ? SHAPE_LEFT : 0) | (node->rchild ? SHAPE_RIGHT : 0));
 
-        if (kolejka.front() != empty)
-            kolejka2.pop();
+        if (node->rchild)
+            stack.push_back(node->rchild);
+        if (node->lchild)
+            stack.push_back(node->lchild);
+    }
+
+    SnapshotWriter writer(path, SnapshotKind::AVLTREE, sizeof(T), values.size());
+    writer.write(values.data(), values.size() * sizeof(T));
+    writer.write(shapes.data(), shapes.size());
+    writer.finish();
+}
+
+template <typename T, typename Compare>
+bool AVLTree<T, Compare>::valid_snapshot(const char *values, const std::uint8_t *shapes, std::size_t count) const
+{
+    std::vector<std::uint64_t> left, right;
+    SnapshotReader::treeChildren(shapes, count, left, right);
+
+    // Children come after their parent in pre-order, so reversed order visits them first
+    std::vector<std::size_t> heights(count);
+    for (std::size_t i = count; i > 0; i--) {
+        std::size_t lheight = left[i - 1] != count ? heights[left[i - 1]] : 0;
+        std::size_t rheight = right[i - 1] != count ? heights[right[i - 1]] : 0;
 
-        kolejka.pop();
+        if (lheight > rheight + 1 || rheight > lheight + 1)
+            return false;
+
+        heights[i - 1] = std::max(lheight, rheight) + 1;
     }
 
-    if (cur_pow != 0)
-        while (cur_pow++ < pow)
-            std::cout << "N ";
+    return SnapshotReader::orderedTree<T>(values, left, right, comp);
+}
+
+template <typename T, typename Compare>
+void AVLTree<T, Compare>::load(const std::string &path)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot stores raw values");
+
+    SnapshotReader reader(path, SnapshotKind::AVLTREE, sizeof(T));
+    std::size_t count = reader.count();
+    const char *values = (const char *)reader.read(count, sizeof(T));
+    const std::uint8_t *shapes = (const std::uint8_t *)reader.read(count, 1);
+    reader.finish();
 
-    std::cout << std::endl;
+    if (!SnapshotReader::validTreeShape(shapes, count))
+        throw std::runtime_error("Snapshot has invalid tree shape!");
+    if (!valid_snapshot(values, shapes, count))
+        throw std::runtime_error("Snapshot is not a valid AVL tree!");
 
-    delete empty;
+    if (root)
+        delete_children(root);
+    root = nullptr;
+    rightmost = nullptr;
+
+    // Empty links waiting for the next node in pre-order, with their parent
+    std::vector<std::pair<Node *, Node **>> slots = { { nullptr, &root } };
+    std::vector<Node *> nodes(count);
+
+    // Shape is rebuilt exactly as saved, without comparisons or rebalancing
+    for (std::size_t i = 0; i < count; i++) {
+        auto [parent, slot] = slots.back();
+        slots.pop_back();
+
+        T value;
+        std::memcpy(&value, values + i * sizeof(T), sizeof(T));
+
+        Node *node = new Node(value);
+        node->parent = parent;
+        *slot = node;
+        nodes[i] = node;
+
+        if (shapes[i] & SHAPE_RIGHT)
+            slots.push_back({ node, &node->rchild });
+        if (shapes[i] & SHAPE_LEFT)
+            slots.push_back({ node, &node->lchild });
+    }
+
+    // Children come after their parent in pre-order, so reversed order visits them first
+    for (std::size_t i = count; i > 0; i--)
+        nodes[i - 1]->fixHeight();
+
+    rightmost = root;
+    while (rightmost && rightmost->rchild)
+        rightmost = rightmost->rchild;
+
+#ifndef NDEBUG
+    checkHeight(root);
+#endif // !NDEBUG
 }
 
 #ifndef NDEBUG
-template <typename T>
-std::size_t AVLTree<T>::checkHeight(Node *node)
+template <typename T, typename Compare>
+std::size_t AVLTree<T, Compare>::checkHeight(Node *node)
 {
     if (!node)
         return 0;
@@ -364,6 +740,8 @@ std::size_t AVLTree<T>::checkHeight(Node *node)
     std::size_t ret = 1 + std::max(checkHeight(node->lchild), checkHeight(node->rchild));
     if (ret != node->height)
         throw std::runtime_error("nope");
+    if (node->getBalance() < -1 || node->getBalance() > 1)
+        throw std::runtime_error("nope");
 
     return ret;
 }
@@ -1,12 +1,24 @@
 #pragma once
 
-template<typename T>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+
+class OutputBuffer;
+template <typename Tree>
+class InterleavedLookup;
+
+template<typename T, typename Compare = std::less<T>>
 class AVLTree {
     enum class RotationDirection
     {
         LEFT, RIGHT
     };
 
+public:
+    // Node pointers act as handles, they stay valid until the node is removed
     struct Node {
         T value;
         std::size_t height = 1;
@@ -15,6 +27,12 @@ class AVLTree {
         Node *lchild = nullptr;
         Node *rchild = nullptr;
 
+        // Value is constructed in place from the arguments
+        template <typename... Args>
+        Node(Args &&...args) : value(std::forward<Args>(args)...)
+        {
+        }
+
         int getBalance() const
         {
             return (rchild ? (long long)rchild->height : 0) -
@@ -27,30 +45,87 @@ class AVLTree {
         }
     };
 
+protected:
+    // Walks the tree with coroutines, see InterleavedLookup.hpp
+    template <typename Tree>
+    friend class InterleavedLookup;
+
     Node *root = nullptr;
+    Compare comp;
+
+    // Largest node, appending in sorted order doesn't need to search for it
+    Node *rightmost = nullptr;
+
+    // Key can be of any type Compare accepts together with T
+    template <typename K>
+    Node *find_node(const K &key) const;
 
+    // Find node matching the key or the empty link where it belongs
+    template <typename K>
+    Node **find_slot(const K &key, Node *&parent);
+
+    // Searches values in groups, walks of a group take turns one level at a time and
+    // prefetch their next node, so cache misses of the group overlap.
+    // found(i, node) is called for every value, node is nullptr if it is not present.
+    // Values may be of any type Compare accepts, like the key of find_node
+    template <typename K, typename F>
+    void find_many(const K *values, std::size_t count, F &&found) const;
+
+    // Attach a new node at the link returned by find_slot
+    void link_node(Node *node, Node *parent, Node **slot);
+    void remove_node(Node *node);
+
+    // Checks balance and order of a snapshot before any node is built, O(n)
+    bool valid_snapshot(const char *values, const std::uint8_t *shapes, std::size_t count) const;
+
+private:
     void delete_children(Node *&node);
 
     // Helpers
-    template <AVLTree<T>::RotationDirection R>
+    template <AVLTree<T, Compare>::RotationDirection R>
     void __rotate_template(Node *node);
 
     void rotate_left(Node *node);
     void rotate_right(Node *node);
+    // Exchange tree positions of a node with two children and its in-order predecessor
+    void swap_with_predecessor(Node *node, Node *predecessor);
     Node *&getParentToSiblingPointer(const Node *child);
     Node *&getParentToChildPointer(const Node *child);
 
     std::size_t checkHeight(Node *node);
 
 public:
-    AVLTree() = default;
+    AVLTree(const Compare &comp = Compare());
     ~AVLTree();
 
-    void add(const T &value);
+    Node *add(const T &value);
     bool remove(const T &value);
     bool contains(const T &value) const;
 
+    // Batched operations, same results as single operations done in order.
+    // Paths of a group of values are fetched together before the group is processed
+    void add_many(const T *values, std::size_t count);
+    // Returns number of removed values
+    std::size_t remove_many(const T *values, std::size_t count);
+    // Results are stored for every value, returns number of values present
+    std::size_t contains_many(const T *values, std::size_t count, bool *results) const;
+
+    // Returns nullptr if value isn't present
+    Node *find(const T &value) const;
+
+    // Insert value right after the hint without searching from the root,
+    // falls back to regular add if value doesn't belong there
+    Node *insert_hint(Node *hint, const T &value);
+    void erase(Node *node);
+
     void print() const;
+    // Same layout as print() through the buffer, plain leaves out terminal colors
+    void dump(OutputBuffer &output, bool plain = false) const;
+
+    // Binary snapshot, see Snapshot.hpp. Loading replaces the contents
+    // and throws std::runtime_error when the file is not a valid snapshot
+    void save(const std::string &path) const;
+    void load(const std::string &path);
 };
 
 // For templates explicit instantiations
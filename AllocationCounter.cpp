@@ -0,0 +1,157 @@
+#include <cstdlib>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif // __unix__ || __APPLE__
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define ALLOCATION_COUNTING
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define malloc_usable_size malloc_size
+#define ALLOCATION_COUNTING
+#endif // __GLIBC__
+
+#include "AllocationCounter.hpp"
+
+static thread_local AllocationCounter::Snapshot counters;
+
+// Only changed before any thread but the main one starts
+static bool countingEnabled = false;
+
+// Blocks are plain malloc blocks with no header, so containers keep the same memory
+// layout whether counting is on or not. Live bytes are taken from the allocator
+static void *countedAllocate(std::size_t size) noexcept
+{
+    void *pointer = std::malloc(size ? size : 1);
+
+#ifdef ALLOCATION_COUNTING
+    if (countingEnabled && pointer) {
+        counters.allocations++;
+        counters.allocatedBytes += size;
+        counters.liveBytes += malloc_usable_size(pointer);
+    }
+#endif // ALLOCATION_COUNTING
+
+    return pointer;
+}
+
+static void countedFree(void *pointer) noexcept
+{
+    if (!pointer)
+        return;
+
+#ifdef ALLOCATION_COUNTING
+    if (countingEnabled) {
+        counters.deallocations++;
+        counters.liveBytes -= malloc_usable_size(pointer);
+    }
+#endif // ALLOCATION_COUNTING
+
+    std::free(pointer);
+}
+
+static void *countedAllocateOrThrow(std::size_t size)
+{
+    void *pointer;
+
+    // Same loop as the default operator new
+    while (!(pointer = countedAllocate(size))) {
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+
+        handler();
+    }
+
+    return pointer;
+}
+
+void *operator new(std::size_t size)
+{
+    return countedAllocateOrThrow(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return countedAllocateOrThrow(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    countedFree(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    countedFree(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    countedFree(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    countedFree(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept
+{
+    countedFree(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept
+{
+    countedFree(pointer);
+}
+
+bool AllocationCounter::enable()
+{
+#ifdef ALLOCATION_COUNTING
+    countingEnabled = true;
+#endif // ALLOCATION_COUNTING
+
+    return countingEnabled;
+}
+
+bool AllocationCounter::enabled()
+{
+    return countingEnabled;
+}
+
+AllocationCounter::Snapshot AllocationCounter::snapshot()
+{
+    return counters;
+}
+
+std::size_t AllocationCounter::peakResidentBytes()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    // Linux reports kilobytes
+    return usage.ru_maxrss * 1024;
+#endif // __APPLE__
+#else
+    return 0;
+#endif // __unix__ || __APPLE__
+}
\ No newline at end of file
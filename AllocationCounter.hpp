@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Counts heap allocations made through global operator new by the calling thread.
+// AllocationCounter.cpp replaces the global operators with plain malloc and free,
+// counting is off until enable() is called and costs a single branch meanwhile.
+class AllocationCounter
+{
+public:
+    struct Snapshot
+    {
+        std::uint64_t allocations = 0;
+        std::uint64_t deallocations = 0;
+        std::uint64_t allocatedBytes = 0;
+        // Memory freed by another thread makes this negative
+        std::int64_t liveBytes = 0;
+    };
+
+    // Turns counting on for the rest of the run, call before other threads start.
+    // Returns false when the allocator can't report block sizes (glibc and macOS can)
+    static bool enable();
+    static bool enabled();
+
+    // All zero while counting is off
+    static Snapshot snapshot();
+
+    // Largest resident set size of the process so far, 0 if unknown
+    static std::size_t peakResidentBytes();
+};
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cstring>
 #include <iostream>
+#include <type_traits>
 
 #include "Array.hpp"
+#include "OutputBuffer.hpp"
 
 using std::size_t;
 
@@ -179,9 +182,47 @@ bool Array<T>::remove(const T &val)
 
 template <typename T>
 void Array<T>::print() const
+{
+    OutputBuffer output;
+    dump(output);
+}
+
+template <typename T>
+void Array<T>::dump(OutputBuffer &output, bool) const
 {
     for (size_t i = 0; i < array_size; i++) {
-        std::cout << array[i] << " ";
+        output.writeValue(array[i]);
+        output.put(' ');
     }
-    std::cout << std::endl;
+    output.put('\n');
+}
+
+template <typename T>
+void Array<T>::save(const std::string &path, SnapshotKind kind) const
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot stores raw values");
+
+    SnapshotWriter writer(path, kind, sizeof(T), array_size);
+    writer.write(array, array_size * sizeof(T));
+    writer.finish();
+}
+
+template <typename T>
+void Array<T>::load(const std::string &path, SnapshotKind kind)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot stores raw values");
+
+    SnapshotReader reader(path, kind, sizeof(T));
+    size_t count = reader.count();
+    const void *values = reader.read(count, sizeof(T));
+    reader.finish();
+
+    // Values are copied straight from the mapped file
+    T *new_array = count ? new T[count] : nullptr;
+    if (count)
+        std::memcpy(new_array, values, count * sizeof(T));
+
+    delete[] array;
+    array = new_array;
+    array_size = count;
 }
\ No newline at end of file
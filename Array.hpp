@@ -1,6 +1,11 @@
 #pragma once
 
 #include <initializer_list>
+#include <string>
+
+#include "Snapshot.hpp"
+
+class OutputBuffer;
 
 template <typename T>
 class Array
@@ -32,6 +37,14 @@ public:
     const T &operator[](const std::size_t &at) const;
     bool remove(const T &val);
     void print() const;
+    // Same layout as print() through the buffer, plain leaves out terminal colors
+    void dump(OutputBuffer &output, bool plain = false) const;
+
+    // Binary snapshot, see Snapshot.hpp. Loading replaces the contents
+    // and throws std::runtime_error when the file is not a valid snapshot.
+    // Containers stored as a plain array pass their own kind
+    void save(const std::string &path, SnapshotKind kind = SnapshotKind::ARRAY) const;
+    void load(const std::string &path, SnapshotKind kind = SnapshotKind::ARRAY);
 };
 
 // For template explicit instantiations
@@ -1,15 +1,26 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 #include "BinHeap.hpp"
+#include "OutputBuffer.hpp"
 
 #define PARENT_OF(child) (((child)-1) / 2)
 #define L_CHILD_OF(parent) (((parent)*2 + 1))
 #define R_CHILD_OF(parent) (((parent)*2 + 2))
 
-template <typename T>
-bool BinHeap<T>::search(const T &value, size_t &index) const
+template <typename T, typename Compare>
+BinHeap<T, Compare>::BinHeap(const Compare &comp) : comp(comp)
+{
+}
+
+template <typename T, typename Compare>
+bool BinHeap<T, Compare>::search(const T &value, size_t &index) const
 {
     index = 0;
 
@@ -22,8 +33,8 @@ bool BinHeap<T>::search(const T &value, size_t &index) const
     return false;
 }
 
-template <typename T>
-void BinHeap<T>::add(const T &value)
+template <typename T, typename Compare>
+void BinHeap<T, Compare>::add(const T &value)
 {
     size_t pos = data.size();
 
@@ -32,7 +43,7 @@ void BinHeap<T>::add(const T &value)
 
     // Heapify upwards
     while (pos != 0) {
-        if (data[pos] > data[PARENT_OF(pos)])
+        if (comp(data[PARENT_OF(pos)], data[pos]))
             std::swap(data[pos], data[PARENT_OF(pos)]);
         pos = PARENT_OF(pos);
     }
@@ -42,8 +53,8 @@ void BinHeap<T>::add(const T &value)
 #endif // !NDEBUG
 }
 
-template <typename T>
-bool BinHeap<T>::remove(const T &value)
+template <typename T, typename Compare>
+bool BinHeap<T, Compare>::remove(const T &value)
 {
     size_t max = data.size() - 1;
     size_t index;
@@ -61,84 +72,292 @@ bool BinHeap<T>::remove(const T &value)
     // It is possible that leaf node was removed and
     // replaced node will be larger than its parent
     // in this case upwards heapify is needed
-    if (index > 0 && data[PARENT_OF(index)] < data[index]) {
+    if (index > 0 && comp(data[PARENT_OF(index)], data[index])) {
         // Heapify upwards
         while (index != 0) {
-            if (data[index] > data[PARENT_OF(index)])
+            if (comp(data[PARENT_OF(index)], data[index]))
                 std::swap(data[index], data[PARENT_OF(index)]);
             index = PARENT_OF(index);
         }
     }
-    else {
-        // Heapify downwards
-        while (1) {
-            size_t child = L_CHILD_OF(index);
-            size_t candidate = index;
-
-            if (child < max && data[candidate] < data[child])
-                candidate = child;
-
-            child = R_CHILD_OF(index);
-            if (child < max && data[candidate] < data[child])
-                candidate = child;
-
-            if (candidate != index) {
-                std::swap(data[index], data[candidate]);
-                index = candidate;
-            }
-            else
-                break;
+    else
+        heapify_down(index);
+
+#ifndef NDEBUG
+    check_max();
+#endif // !NDEBUG
+
+    return true;
+}
+
+template <typename T, typename Compare>
+void BinHeap<T, Compare>::heapify_down(size_t index)
+{
+    size_t size = data.size();
+
+    while (1) {
+        size_t child = L_CHILD_OF(index);
+        size_t candidate = index;
+
+        if (child < size && comp(data[candidate], data[child]))
+            candidate = child;
+
+        child = R_CHILD_OF(index);
+        if (child < size && comp(data[candidate], data[child]))
+            candidate = child;
+
+        if (candidate != index) {
+            std::swap(data[index], data[candidate]);
+            index = candidate;
         }
+        else
+            break;
     }
+}
+
+template <typename T, typename Compare>
+void BinHeap<T, Compare>::build_heap()
+{
+    size_t size = data.size();
+
+    for (size_t index = size / 2; index-- > 0;)
+        heapify_down(index);
+}
+
+template <typename T, typename Compare>
+void BinHeap<T, Compare>::add_many(const T *values, std::size_t count)
+{
+    size_t size = data.size();
+
+    if (count == 0)
+        return;
+
+    // Sifting every value up costs log n each, rebuilding pays off for large batches
+    if (count < size / 8) {
+        for (size_t i = 0; i < count; i++)
+            add(values[i]);
+        return;
+    }
+
+    data.resize(size + count);
+    std::copy(values, values + count, &data[0] + size);
+    build_heap();
 
 #ifndef NDEBUG
     check_max();
 #endif // !NDEBUG
+}
 
-    return true;
+template <typename T, typename Compare>
+std::size_t BinHeap<T, Compare>::remove_many(const T *values, std::size_t count)
+{
+    if (count == 0 || data.size() == 0)
+        return 0;
+
+    // Every value removes at most one occurrence, so duplicates are counted
+    std::vector<T> keys(values, values + count);
+    std::sort(keys.begin(), keys.end(), comp);
+
+    std::vector<std::size_t> pending;
+    size_t unique = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (unique > 0 && !comp(keys[unique - 1], keys[i])) {
+            pending[unique - 1]++;
+            continue;
+        }
+        keys[unique++] = keys[i];
+        pending.push_back(1);
+    }
+    keys.resize(unique);
+
+    size_t kept = 0;
+    for (size_t index = 0; index < data.size(); index++) {
+        auto key = std::lower_bound(keys.begin(), keys.end(), data[index], comp);
+
+        if (key != keys.end() && !comp(data[index], *key) && pending[key - keys.begin()] > 0) {
+            pending[key - keys.begin()]--;
+            continue;
+        }
+        data[kept++] = data[index];
+    }
+
+    size_t removed = data.size() - kept;
+    if (removed == 0)
+        return 0;
+
+    data.resize(kept);
+    build_heap();
+
+#ifndef NDEBUG
+    check_max();
+#endif // !NDEBUG
+
+    return removed;
 }
 
-template <typename T>
-bool BinHeap<T>::contains(const T &value) const
+template <typename T, typename Compare>
+std::size_t BinHeap<T, Compare>::contains_many(const T *values, std::size_t count, bool *results) const
+{
+    if (count == 0)
+        return 0;
+
+    std::vector<T> keys(values, values + count);
+    std::sort(keys.begin(), keys.end(), comp);
+    std::vector<char> seen(count, 0);
+
+    // Heap is scanned once, every element is looked up in the sorted values.
+    // The search has no branches, elements are random so they would be mispredicted
+    for (size_t index = 0; index < data.size(); index++) {
+        const T &value = data[index];
+        const T *base = keys.data();
+        size_t size = count;
+
+        while (size > 1) {
+            size_t half = size / 2;
+            base = comp(base[half - 1], value) ? base + half : base;
+            size -= half;
+        }
+
+        if (!comp(*base, value) && !comp(value, *base))
+            seen[base - keys.data()] = 1;
+    }
+
+    // Search stops at the first of equal values
+    std::size_t present = 0;
+    for (size_t i = 0; i < count; i++) {
+        auto key = std::lower_bound(keys.begin(), keys.end(), values[i], comp);
+        results[i] = seen[key - keys.begin()];
+        present += results[i];
+    }
+
+    return present;
+}
+
+template <typename T, typename Compare>
+const T &BinHeap<T, Compare>::top() const
+{
+    return data[0];
+}
+
+template <typename T, typename Compare>
+void BinHeap<T, Compare>::pop()
+{
+    if (data.size() == 0)
+        return;
+
+    size_t last = data.size() - 1;
+
+    data[0] = data[last];
+    data.resize(last);
+
+    if (last > 1)
+        heapify_down(0);
+
+#ifndef NDEBUG
+    check_max();
+#endif // !NDEBUG
+}
+
+template <typename T, typename Compare>
+bool BinHeap<T, Compare>::empty() const
+{
+    return data.size() == 0;
+}
+
+template <typename T, typename Compare>
+bool BinHeap<T, Compare>::contains(const T &value) const
 {
     return data.contains(value);
 }
 
-template <typename T>
-void BinHeap<T>::print() const
+template <typename T, typename Compare>
+void BinHeap<T, Compare>::print() const
+{
+    OutputBuffer output;
+    dump(output);
+}
+
+template <typename T, typename Compare>
+void BinHeap<T, Compare>::dump(OutputBuffer &output, bool) const
 {
     std::size_t row = 0, pow = 1;
 
     for (std::size_t i = 0; i < data.size(); i++) {
-        std::cout << data[i] << " ";
+        output.writeValue(data[i]);
+        output.put(' ');
 
+        // Every level of the heap in its own line
         if (i == row) {
             pow *= 2;
             row += pow;
-            std::cout << std::endl;
+            output.put('\n');
         }
     }
 
-    std::cout << std::endl;
+    output.put('\n');
+}
+
+template <typename T, typename Compare>
+void BinHeap<T, Compare>::save(const std::string &path) const
+{
+    data.save(path, SnapshotKind::BINHEAP);
+}
+
+template <typename T, typename Compare>
+bool BinHeap<T, Compare>::valid_snapshot(const char *values, std::size_t count) const
+{
+    T parent, child;
+
+    for (std::size_t i = 1; i < count; i++) {
+        std::memcpy(&parent, values + PARENT_OF(i) * sizeof(T), sizeof(T));
+        std::memcpy(&child, values + i * sizeof(T), sizeof(T));
+
+        if (comp(parent, child))
+            return false;
+    }
+
+    return true;
+}
+
+template <typename T, typename Compare>
+void BinHeap<T, Compare>::load(const std::string &path)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot stores raw values");
+
+    SnapshotReader reader(path, SnapshotKind::BINHEAP, sizeof(T));
+    std::size_t count = reader.count();
+    const char *values = (const char *)reader.read(count, sizeof(T));
+    reader.finish();
+
+    if (!valid_snapshot(values, count))
+        throw std::runtime_error("Snapshot is not a valid heap!");
+
+    data.resize(count);
+    if (count)
+        std::memcpy(&data[0], values, count * sizeof(T));
+
+#ifndef NDEBUG
+    check_max();
+#endif // !NDEBUG
 }
 
 #ifndef NDEBUG
 #include <queue>
 
-template <typename T>
-void BinHeap<T>::check_max() const
+template <typename T, typename Compare>
+void BinHeap<T, Compare>::check_max() const
 {
     std::queue<size_t> checkQueue;
     checkQueue.push(0);
 
     while (!checkQueue.empty()) {
         if (L_CHILD_OF(checkQueue.front()) < data.size()) {
-            if (data[L_CHILD_OF(checkQueue.front())] > data[checkQueue.front()])
+            if (comp(data[checkQueue.front()], data[L_CHILD_OF(checkQueue.front())]))
                 throw std::runtime_error("nope");
             checkQueue.push(L_CHILD_OF(checkQueue.front()));
         }
         if (R_CHILD_OF(checkQueue.front()) < data.size()) {
-            if (data[R_CHILD_OF(checkQueue.front())] > data[checkQueue.front()])
+            if (comp(data[checkQueue.front()], data[R_CHILD_OF(checkQueue.front())]))
                 throw std::runtime_error("nope");
             checkQueue.push(R_CHILD_OF(checkQueue.front()));
         }
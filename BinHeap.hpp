@@ -1,22 +1,56 @@
 #pragma once
 
+#include <functional>
+#include <string>
+
 #include "Array.hpp"
 
-template<typename T>
+// Compare follows std::priority_queue, the largest element is kept on top
+template<typename T, typename Compare = std::less<T>>
 class BinHeap {
     Array<T> data;
+    Compare comp;
 
     bool search(const T &value, size_t &index) const;
+    void heapify_down(size_t index);
+    // Restores heap order of the whole array bottom-up, O(n)
+    void build_heap();
+    // Checks heap order of a snapshot before the contents are replaced, O(n)
+    bool valid_snapshot(const char *values, std::size_t count) const;
 
 #ifndef NDEBUG
     void check_max() const;
 #endif // NDEBUG
 
 public:
+    BinHeap(const Compare &comp = Compare());
+
     void add(const T &value);
     bool remove(const T &value);
     bool contains(const T &value) const;
+
+    // Batched operations, same contents as after single operations done in order.
+    // Each one makes a single pass over the heap instead of one per value
+    void add_many(const T *values, std::size_t count);
+    // Returns number of removed values
+    std::size_t remove_many(const T *values, std::size_t count);
+    // Results are stored for every value, returns number of values present
+    std::size_t contains_many(const T *values, std::size_t count, bool *results) const;
+
+    // Largest element of the heap
+    const T &top() const;
+    // Remove the largest element, does nothing if heap is empty
+    void pop();
+    bool empty() const;
+
     void print() const;
+    // Same layout as print() through the buffer, plain leaves out terminal colors
+    void dump(OutputBuffer &output, bool plain = false) const;
+
+    // Binary snapshot, see Snapshot.hpp. Loading replaces the contents
+    // and throws std::runtime_error when the file is not a valid snapshot
+    void save(const std::string &path) const;
+    void load(const std::string &path);
 };
 
 // For template explicit instantiations
@@ -0,0 +1,249 @@
+#include "ContainerServer.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif // __linux__
+
+static_assert(sizeof(ServerRequest) == 8, "Server request must not contain padding");
+
+static volatile std::sig_atomic_t stopRequested = 0;
+
+static void requestStop(int)
+{
+    stopRequested = 1;
+}
+
+#ifdef __linux__
+static std::runtime_error systemError(const std::string &what)
+{
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+#endif // __linux__
+
+ContainerServer::ContainerServer(const std::string &path, Handler handler) : path(path), handler(handler)
+{
+#ifdef __linux__
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("Socket path is too long!");
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0)
+        throw systemError("Cannot create socket");
+
+    // Socket file left by a previous run would make bind fail
+    unlink(path.c_str());
+
+    if (bind(listenFd, (sockaddr *)&address, sizeof(address)) != 0 || listen(listenFd, SOMAXCONN) != 0) {
+        std::runtime_error error = systemError("Cannot listen on " + path);
+        close(listenFd);
+        throw error;
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+
+    if (epollFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) != 0) {
+        std::runtime_error error = systemError("Cannot create epoll");
+        if (epollFd >= 0)
+            close(epollFd);
+        close(listenFd);
+        unlink(path.c_str());
+        throw error;
+    }
+#else
+    throw std::runtime_error("Server mode is supported only on Linux");
+#endif // __linux__
+}
+
+ContainerServer::~ContainerServer()
+{
+#ifdef __linux__
+    for (auto &connection : connections)
+        close(connection.first);
+
+    close(epollFd);
+    close(listenFd);
+    unlink(path.c_str());
+#endif // __linux__
+}
+
+void ContainerServer::run()
+{
+#ifdef __linux__
+    // No SA_RESTART, a signal has to interrupt epoll_wait
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = requestStop;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    // Client closing its socket early must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    stopRequested = 0;
+    epoll_event events[64];
+
+    while (!stopRequested) {
+        int count = epoll_wait(epollFd, events, 64, -1);
+
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            throw systemError("epoll_wait failed");
+        }
+
+        for (int i = 0; i < count; i++) {
+            int fd = events[i].data.fd;
+
+            if (fd == listenFd) {
+                acceptClients();
+                continue;
+            }
+
+            auto found = connections.find(fd);
+            if (found == connections.end())
+                continue;
+
+            bool open = true;
+            if (events[i].events & (EPOLLERR | EPOLLHUP) && !(events[i].events & EPOLLIN))
+                open = false;
+            if (open && events[i].events & EPOLLOUT)
+                open = writeResponses(fd, found->second);
+            if (open && events[i].events & EPOLLIN && found->second.events & EPOLLIN)
+                open = readRequests(fd, found->second);
+
+            if (!open)
+                closeConnection(fd);
+        }
+    }
+#endif // __linux__
+}
+
+void ContainerServer::acceptClients()
+{
+#ifdef __linux__
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return;
+
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            continue;
+        }
+
+        Connection &connection = connections[fd];
+        connection.input.resize(INPUT_REQUESTS);
+        connection.events = EPOLLIN;
+    }
+#endif // __linux__
+}
+
+bool ContainerServer::readRequests(int fd, Connection &connection)
+{
+#ifdef __linux__
+    char *buffer = (char *)connection.input.data();
+    std::size_t capacity = connection.input.size() * sizeof(ServerRequest);
+
+    ssize_t count = read(fd, buffer + connection.received, capacity - connection.received);
+    if (count == 0)
+        return false;
+    if (count < 0)
+        return errno == EAGAIN || errno == EINTR;
+
+    connection.received += count;
+    std::size_t requests = connection.received / sizeof(ServerRequest);
+
+    if (requests) {
+        // Responses are produced in place at the end of the pending output
+        std::size_t pending = connection.output.size();
+        connection.output.resize(pending + requests);
+        handler(connection.input.data(), requests, connection.output.data() + pending);
+
+        // Part of the next request stays at the front of the buffer
+        std::size_t used = requests * sizeof(ServerRequest);
+        std::memmove(buffer, buffer + used, connection.received - used);
+        connection.received -= used;
+    }
+
+    return writeResponses(fd, connection);
+#else
+    (void)fd;
+    (void)connection;
+    return false;
+#endif // __linux__
+}
+
+bool ContainerServer::writeResponses(int fd, Connection &connection)
+{
+#ifdef __linux__
+    while (connection.sent < connection.output.size()) {
+        ssize_t count = write(fd, connection.output.data() + connection.sent,
+                              connection.output.size() - connection.sent);
+
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count < 0 && errno != EAGAIN)
+            return false;
+        if (count < 0)
+            break;
+
+        connection.sent += count;
+    }
+
+    if (connection.sent == connection.output.size()) {
+        connection.output.clear();
+        connection.sent = 0;
+    }
+
+    // Client that does not read its responses stops being read from
+    std::uint32_t events = connection.output.size() > OUTPUT_LIMIT ? 0u : (std::uint32_t)EPOLLIN;
+    if (!connection.output.empty())
+        events |= EPOLLOUT;
+
+    if (events != connection.events) {
+        epoll_event event;
+        event.events = events;
+        event.data.fd = fd;
+
+        if (epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event) != 0)
+            return false;
+        connection.events = events;
+    }
+
+    return true;
+#else
+    (void)fd;
+    (void)connection;
+    return false;
+#endif // __linux__
+}
+
+void ContainerServer::closeConnection(int fd)
+{
+#ifdef __linux__
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+#endif // __linux__
+
+    connections.erase(fd);
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Binary protocol over a Unix domain socket, native byte order as both ends are local.
+// Clients may pipeline any number of requests, responses come back in the same order.
+enum ServerOperation : std::uint8_t
+{
+    SERVER_ADD = 'a',
+    SERVER_REMOVE = 'x',
+    SERVER_CONTAINS = 'c'
+};
+
+struct ServerRequest
+{
+    std::uint8_t operation;
+    std::uint8_t reserved[3];
+    std::int32_t value;
+};
+
+// One byte per request: result of contains or remove, 1 for add
+enum ServerResponse : std::uint8_t
+{
+    SERVER_FALSE = 0,
+    SERVER_TRUE = 1,
+    SERVER_UNKNOWN_OPERATION = 0xFF
+};
+
+// Single threaded epoll server, containers are not shared between threads.
+// Every batch of requests read at once is passed to the handler together and its
+// responses are written straight into the output buffer of the connection.
+class ContainerServer
+{
+public:
+    typedef std::function<void(const ServerRequest *requests, std::size_t count, std::uint8_t *responses)> Handler;
+
+    // Throws std::runtime_error when the socket cannot be created, Linux only
+    ContainerServer(const std::string &path, Handler handler);
+    ~ContainerServer();
+
+    ContainerServer(const ContainerServer &) = delete;
+    ContainerServer &operator=(const ContainerServer &) = delete;
+
+    // Serves clients until SIGINT or SIGTERM
+    void run();
+
+private:
+    struct Connection
+    {
+        std::vector<ServerRequest> input;
+        // Bytes of input holding received data, may end with part of a request
+        std::size_t received = 0;
+        std::vector<std::uint8_t> output;
+        std::size_t sent = 0;
+        // Events the connection is registered for in epoll
+        std::uint32_t events = 0;
+    };
+
+    // Connection stops reading while this many responses are waiting for the client
+    static constexpr std::size_t OUTPUT_LIMIT = 1 << 20;
+    static constexpr std::size_t INPUT_REQUESTS = 8192;
+
+    std::string path;
+    Handler handler;
+    int listenFd = -1;
+    int epollFd = -1;
+    std::unordered_map<int, Connection> connections;
+
+    void acceptClients();
+    // Return false when the connection has to be closed
+    bool readRequests(int fd, Connection &connection);
+    bool writeResponses(int fd, Connection &connection);
+    void closeConnection(int fd);
+};
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "CpuAffinity.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif // __linux__
+
+#ifdef __linux__
+static std::string readLine(const std::string &path)
+{
+    std::ifstream file(path);
+    std::string line;
+
+    std::getline(file, line);
+
+    return line;
+}
+#endif // __linux__
+
+std::vector<int> CpuAffinity::parseList(const std::string &text)
+{
+    std::vector<int> cpus;
+    std::size_t position = 0;
+
+    while (position < text.size()) {
+        std::size_t end = text.find(',', position);
+        if (end == std::string::npos)
+            end = text.size();
+
+        std::string range = text.substr(position, end - position);
+        position = end + 1;
+
+        if (range.empty())
+            continue;
+
+        std::size_t dash = range.find('-');
+        std::size_t parsed;
+        int first = std::stoi(range, &parsed);
+        int last = first;
+
+        if (dash != std::string::npos) {
+            if (parsed != dash)
+                throw std::invalid_argument(range);
+            last = std::stoi(range.substr(dash + 1));
+        }
+
+        if (first < 0 || last < first)
+            throw std::invalid_argument(range);
+
+        for (int cpu = first; cpu <= last; cpu++)
+            cpus.push_back(cpu);
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+
+    return cpus;
+}
+
+std::vector<int> CpuAffinity::allowed()
+{
+    std::vector<int> cpus;
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+        return cpus;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        if (CPU_ISSET(cpu, &set))
+            cpus.push_back(cpu);
+#endif // __linux__
+
+    return cpus;
+}
+
+std::vector<int> CpuAffinity::isolated()
+{
+#ifdef __linux__
+    return parseList(readLine("/sys/devices/system/cpu/isolated"));
+#else
+    return {};
+#endif // __linux__
+}
+
+std::vector<int> CpuAffinity::withoutSmtSiblings(const std::vector<int> &cpus)
+{
+#ifdef __linux__
+    std::vector<int> cores;
+
+    for (int cpu : cpus) {
+        std::string siblings = readLine("/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                                        "/topology/thread_siblings_list");
+
+        // Topology is unknown, treat every CPU as a core
+        std::vector<int> threads = siblings.empty() ? std::vector<int>{ cpu } : parseList(siblings);
+
+        bool firstThread = true;
+        for (int thread : threads)
+            if (thread < cpu && std::find(cpus.begin(), cpus.end(), thread) != cpus.end())
+                firstThread = false;
+
+        if (firstThread)
+            cores.push_back(cpu);
+    }
+
+    return cores;
+#else
+    return cpus;
+#endif // __linux__
+}
+
+bool CpuAffinity::pinCurrentThread(int cpu)
+{
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+        return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif // __linux__
+}
\ No newline at end of file
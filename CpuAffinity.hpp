@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// CPU sets of the process and pinning of the calling thread, Linux only.
+// Elsewhere every query returns an empty set and pinning does nothing.
+class CpuAffinity
+{
+public:
+    // Parses kernel list format, e.g. "0-3,8,10-11"
+    static std::vector<int> parseList(const std::string &text);
+
+    // CPUs the process is allowed to run on
+    static std::vector<int> allowed();
+
+    // CPUs removed from the scheduler with isolcpus
+    static std::vector<int> isolated();
+
+    // Keeps only the first hardware thread of every physical core
+    static std::vector<int> withoutSmtSiblings(const std::vector<int> &cpus);
+
+    // Returns false when the CPU cannot be used
+    static bool pinCurrentThread(int cpu);
+};
\ No newline at end of file
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "InterleavedLookup.hpp"
+
+#ifdef INTERLEAVED_LOOKUP
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+template <typename Tree>
+InterleavedLookup<Tree>::InterleavedLookup(const Tree &tree, std::size_t width) : tree(tree), width(width)
+{
+    if (width == 0)
+        throw std::invalid_argument("At least one lookup must be in flight");
+}
+
+template <typename Tree>
+template <typename Start>
+void InterleavedLookup<Tree>::run(std::size_t count, Start &&start) const
+{
+    std::vector<LookupTask> tasks;
+    std::size_t next = 0;
+
+    tasks.reserve(std::min(width, count));
+
+    while (tasks.size() < width && next < count)
+        tasks.push_back(start(next++));
+
+    // Finished slots are refilled right away, so width lookups stay in flight
+    std::size_t active = tasks.size();
+    while (active) {
+        for (auto &task : tasks) {
+            if (!task)
+                continue;
+
+            task.resume();
+            if (!task.done())
+                continue;
+
+            if (next < count)
+                task = start(next++);
+            else {
+                task = LookupTask();
+                active--;
+            }
+        }
+    }
+}
+
+template <typename Tree>
+LookupTask InterleavedLookup<Tree>::find_task(const T &value, bool &result) const
+{
+    const Node *node = tree.root;
+
+    if (node)
+        co_await PrefetchAwaiter{ node };
+
+    while (node) {
+        if (tree.comp(value, node->value))
+            node = node->lchild;
+        else if (tree.comp(node->value, value))
+            node = node->rchild;
+        else
+            break;
+
+        if (node)
+            co_await PrefetchAwaiter{ node };
+    }
+
+    result = node != nullptr;
+}
+
+template <typename Tree>
+LookupTask InterleavedLookup<Tree>::lower_bound_task(const T &value, const Node *&result) const
+{
+    const Node *node = tree.root;
+    const Node *bound = nullptr;
+
+    if (node)
+        co_await PrefetchAwaiter{ node };
+
+    // Equal values continue to the left, the first of them is found
+    while (node) {
+        if (tree.comp(node->value, value))
+            node = node->rchild;
+        else {
+            bound = node;
+            node = node->lchild;
+        }
+
+        if (node)
+            co_await PrefetchAwaiter{ node };
+    }
+
+    result = bound;
+}
+
+template <typename Tree>
+LookupTask InterleavedLookup<Tree>::count_range_task(const T &low, const T &high, std::size_t &result) const
+{
+    const Node *node = tree.root;
+    const Node *bound = nullptr;
+
+    if (node)
+        co_await PrefetchAwaiter{ node };
+
+    while (node) {
+        if (tree.comp(node->value, low))
+            node = node->rchild;
+        else {
+            bound = node;
+            node = node->lchild;
+        }
+
+        if (node)
+            co_await PrefetchAwaiter{ node };
+    }
+
+    std::size_t found = 0;
+    node = bound;
+
+    while (node && !tree.comp(high, node->value)) {
+        found++;
+
+        // Successor is the leftmost node of the right subtree or the first ancestor
+        // reached from the left, ancestors were already visited and are cached
+        if (node->rchild) {
+            node = node->rchild;
+            co_await PrefetchAwaiter{ node };
+
+            while (node->lchild) {
+                node = node->lchild;
+                co_await PrefetchAwaiter{ node };
+            }
+        }
+        else {
+            while (node->parent && node == node->parent->rchild)
+                node = node->parent;
+            node = node->parent;
+        }
+    }
+
+    result = found;
+}
+
+template <typename Tree>
+std::size_t InterleavedLookup<Tree>::contains(const T *values, std::size_t count, bool *results) const
+{
+    run(count, [&](std::size_t i) { return find_task(values[i], results[i]); });
+
+    std::size_t present = 0;
+    for (std::size_t i = 0; i < count; i++)
+        present += results[i];
+
+    return present;
+}
+
+template <typename Tree>
+void InterleavedLookup<Tree>::lower_bound(const T *values, std::size_t count, const Node **results) const
+{
+    run(count, [&](std::size_t i) { return lower_bound_task(values[i], results[i]); });
+}
+
+template <typename Tree>
+std::size_t InterleavedLookup<Tree>::count_range(const T *low, const T *high, std::size_t count,
+                                                 std::size_t *results) const
+{
+    run(count, [&](std::size_t i) { return count_range_task(low[i], high[i], results[i]); });
+
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < count; i++)
+        total += results[i];
+
+    return total;
+}
+
+#endif // INTERLEAVED_LOOKUP
\ No newline at end of file
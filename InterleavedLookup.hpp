@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+
+#include "LookupTask.hpp"
+
+#ifdef INTERLEAVED_LOOKUP
+
+// Lookups over RBTree or AVLTree running as coroutines. Up to width lookups are in
+// flight and resumed round-robin, each one suspends right after prefetching the next
+// node it reads. Unlike contains_many any traversal can be written this way, the tree
+// must not change while lookups run
+template <typename Tree>
+class InterleavedLookup
+{
+    using Node = typename Tree::Node;
+    using T = decltype(Node::value);
+
+    const Tree &tree;
+    std::size_t width;
+
+    // Starts start(0) ... start(count - 1) and resumes them until all are done
+    template <typename Start>
+    void run(std::size_t count, Start &&start) const;
+
+    LookupTask find_task(const T &value, bool &result) const;
+    LookupTask lower_bound_task(const T &value, const Node *&result) const;
+    LookupTask count_range_task(const T &low, const T &high, std::size_t &result) const;
+
+public:
+    // Throws std::invalid_argument when width is 0
+    InterleavedLookup(const Tree &tree, std::size_t width);
+
+    // Results are stored for every value, returns number of values present
+    std::size_t contains(const T *values, std::size_t count, bool *results) const;
+
+    // First node not less than each value (successor query), nullptr past the largest
+    void lower_bound(const T *values, std::size_t count, const Node **results) const;
+
+    // Number of values within [low[i], high[i]] found by an in-order scan, returns the sum
+    std::size_t count_range(const T *low, const T *high, std::size_t count, std::size_t *results) const;
+};
+
+// For template explicit instantiations
+#include "InterleavedLookup.cpp"
+
+#endif // INTERLEAVED_LOOKUP
\ No newline at end of file
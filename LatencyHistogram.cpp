@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cmath>
+
+#include "LatencyHistogram.hpp"
+
+LatencyHistogram::LatencyHistogram() : counts(BUCKET_COUNT, 0)
+{
+}
+
+std::uint64_t LatencyHistogram::bucketHighestValue(std::size_t bucket)
+{
+    if (bucket < SUB_BUCKET_COUNT)
+        return bucket;
+
+    unsigned shift = bucket / SUB_BUCKET_COUNT - 1;
+    std::uint64_t top = bucket % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+
+    return ((top + 1) << shift) - 1;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (std::size_t i = 0; i < BUCKET_COUNT; i++)
+        counts[i] += other.counts[i];
+
+    total += other.total;
+    maxValue = std::max(maxValue, other.maxValue);
+}
+
+void LatencyHistogram::clear()
+{
+    std::fill(counts.begin(), counts.end(), 0);
+    total = 0;
+    maxValue = 0;
+}
+
+std::uint64_t LatencyHistogram::count() const
+{
+    return total;
+}
+
+std::uint64_t LatencyHistogram::max() const
+{
+    return maxValue;
+}
+
+std::uint64_t LatencyHistogram::percentile(double percent) const
+{
+    if (total == 0)
+        return 0;
+
+    std::uint64_t target = std::ceil(percent / 100 * total);
+    target = std::clamp<std::uint64_t>(target, 1, total);
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += counts[i];
+
+        if (seen >= target)
+            return std::min(bucketHighestValue(i), maxValue);
+    }
+
+    return maxValue;
+}
\ No newline at end of file
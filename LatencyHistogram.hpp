@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Log-bucketed histogram in the spirit of HdrHistogram. Values below 64 are
+// stored exactly, larger values with a relative precision of 1/32.
+// Memory is allocated once in the constructor, recording never allocates.
+class LatencyHistogram
+{
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr std::size_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static constexpr std::size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    std::vector<std::uint64_t> counts;
+    std::uint64_t total = 0;
+    std::uint64_t maxValue = 0;
+
+    static std::size_t bucketOf(std::uint64_t value)
+    {
+        if (value < SUB_BUCKET_COUNT)
+            return value;
+
+        // Keep the highest SUB_BUCKET_BITS + 1 bits of the value
+        unsigned shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+        return shift * SUB_BUCKET_COUNT + (value >> shift);
+    }
+
+    static std::uint64_t bucketHighestValue(std::size_t bucket);
+
+public:
+    LatencyHistogram();
+
+    void record(std::uint64_t value)
+    {
+        counts[bucketOf(value)]++;
+        total++;
+
+        if (value > maxValue)
+            maxValue = value;
+    }
+
+    void merge(const LatencyHistogram &other);
+    void clear();
+
+    std::uint64_t count() const;
+    std::uint64_t max() const;
+
+    // Smallest value that is not exceeded by the given percent of recorded values
+    std::uint64_t percentile(double percent) const;
+};
\ No newline at end of file
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <cstring>
 #include <iostream>
+#include <type_traits>
+#include <vector>
 
 #include "List.hpp"
+#include "OutputBuffer.hpp"
+#include "Snapshot.hpp"
 
 template <typename T>
 List<T>::~List()
@@ -18,7 +23,7 @@ List<T>::~List()
 }
 
 template <typename T>
-void List<T>::push_front(const T &val)
+auto List<T>::push_front(const T &val) -> Node *
 {
     Node *swap = head;
 
@@ -31,10 +36,12 @@ void List<T>::push_front(const T &val)
     else
         // If theres no head, tail is nullptr too
         tail = head;
+
+    return head;
 }
 
 template <typename T>
-void List<T>::push_back(const T &val)
+auto List<T>::push_back(const T &val) -> Node *
 {
     Node *node = new Node();
     node->val = val;
@@ -47,10 +54,12 @@ void List<T>::push_back(const T &val)
         head = node;
 
     tail = node;
+
+    return node;
 }
 
 template <typename T>
-void List<T>::insert(const T &val, Node *&at)
+auto List<T>::insert(const T &val, Node *&at) -> Node *
 {
     if (!at)
         throw std::runtime_error("Node is empty!");
@@ -70,6 +79,8 @@ void List<T>::insert(const T &val, Node *&at)
     // before at
 
     at->prev = node;
+
+    return node;
 }
 
 template <typename T>
@@ -175,13 +186,57 @@ auto List<T>::get_node(const T &val) const -> List<T>::Node *
 
 template <typename T>
 void List<T>::print() const
+{
+    OutputBuffer output;
+    dump(output);
+}
+
+template <typename T>
+void List<T>::dump(OutputBuffer &output, bool) const
 {
     Node *node = head;
 
     while (node) {
-        std::cout << node->val << " ";
+        output.writeValue(node->val);
+        output.put(' ');
 
         node = node->next;
     }
-    std::cout << std::endl;
+    output.put('\n');
+}
+
+template <typename T>
+void List<T>::save(const std::string &path) const
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot stores raw values");
+
+    std::vector<T> values;
+    for (Node *node = head; node; node = node->next)
+        values.push_back(node->val);
+
+    SnapshotWriter writer(path, SnapshotKind::LIST, sizeof(T), values.size());
+    writer.write(values.data(), values.size() * sizeof(T));
+    writer.finish();
+}
+
+template <typename T>
+void List<T>::load(const std::string &path)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot stores raw values");
+
+    SnapshotReader reader(path, SnapshotKind::LIST, sizeof(T));
+    std::size_t count = reader.count();
+    const char *values = (const char *)reader.read(count, sizeof(T));
+    reader.finish();
+
+    List<T> loaded;
+    for (std::size_t i = 0; i < count; i++) {
+        T val;
+        std::memcpy(&val, values + i * sizeof(T), sizeof(T));
+        loaded.push_back(val);
+    }
+
+    // Old nodes are freed by the destructor of loaded
+    std::swap(head, loaded.head);
+    std::swap(tail, loaded.tail);
 }
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <string>
+
+class OutputBuffer;
+
 template <typename T>
 class List
 {
@@ -14,9 +18,10 @@ public:
     List() = default;
     ~List();
 
-    void push_front(const T &val);
-    void push_back(const T &val);
-    void insert(const T &val, Node *&at);
+    // Returned node stays valid until it is removed
+    Node *push_front(const T &val);
+    Node *push_back(const T &val);
+    Node *insert(const T &val, Node *&at);
 
     // Find first node with matching value
     Node *get_node(const T &val) const;
@@ -29,6 +34,13 @@ public:
 
     bool contains(const T &val) const;
     void print() const;
+    // Same layout as print() through the buffer, plain leaves out terminal colors
+    void dump(OutputBuffer &output, bool plain = false) const;
+
+    // Binary snapshot, see Snapshot.hpp. Loading replaces the contents
+    // and throws std::runtime_error when the file is not a valid snapshot
+    void save(const std::string &path) const;
+    void load(const std::string &path);
 
 private:
     Node *head = nullptr;
@@ -0,0 +1,118 @@
+#include "LoadGenerator.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "ContainerServer.hpp"
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif // __linux__
+
+LoadGenerator::LoadGenerator(const std::string &path)
+{
+#ifdef __linux__
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("Socket path is too long!");
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, (sockaddr *)&address, sizeof(address)) != 0) {
+        std::string error = std::strerror(errno);
+        if (fd >= 0)
+            close(fd);
+        throw std::runtime_error("Cannot connect to " + path + ": " + error);
+    }
+#else
+    (void)path;
+    throw std::runtime_error("Load generator is supported only on Linux");
+#endif // __linux__
+}
+
+LoadGenerator::~LoadGenerator()
+{
+#ifdef __linux__
+    close(fd);
+#endif // __linux__
+}
+
+auto LoadGenerator::run(const Options &options) -> Result
+{
+    Result result;
+
+#ifdef __linux__
+    if (options.pipeline == 0 || options.pipeline > MAX_PIPELINE || options.keyRange <= 0 || options.contains + options.add + options.remove == 0)
+        throw std::invalid_argument("Invalid load generator options");
+
+    std::default_random_engine generator(options.seed);
+    std::uniform_int_distribution<std::int32_t> values(0, options.keyRange - 1);
+    std::uniform_int_distribution<unsigned> operations(0, options.contains + options.add + options.remove - 1);
+
+    // Requests are generated before the clock starts
+    std::vector<ServerRequest> requests(options.requests);
+    for (auto &request : requests) {
+        unsigned operation = operations(generator);
+
+        std::memset(&request, 0, sizeof(request));
+        request.operation = operation < options.contains ? SERVER_CONTAINS :
+            operation < options.contains + options.add ? SERVER_ADD : SERVER_REMOVE;
+        request.value = values(generator);
+    }
+
+    std::vector<std::uint8_t> responses(options.pipeline);
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t first = 0; first < requests.size(); first += options.pipeline) {
+        std::size_t count = std::min(options.pipeline, requests.size() - first);
+        auto batchStart = std::chrono::steady_clock::now();
+
+        const char *data = (const char *)&requests[first];
+        std::size_t bytes = count * sizeof(ServerRequest);
+
+        for (std::size_t sent = 0; sent < bytes;) {
+            ssize_t written = write(fd, data + sent, bytes - sent);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                throw std::runtime_error("Cannot send requests: " + std::string(std::strerror(errno)));
+            sent += written;
+        }
+
+        for (std::size_t received = 0; received < count;) {
+            ssize_t got = read(fd, responses.data() + received, count - received);
+            if (got < 0 && errno == EINTR)
+                continue;
+            if (got <= 0)
+                throw std::runtime_error("Server closed the connection");
+            received += got;
+        }
+
+        result.latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - batchStart).count());
+
+        for (std::size_t i = 0; i < count; i++) {
+            if (responses[i] == SERVER_UNKNOWN_OPERATION)
+                throw std::runtime_error("Server rejected a request");
+            result.hits += responses[i] == SERVER_TRUE;
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.requests = requests.size();
+#else
+    (void)options;
+#endif // __linux__
+
+    return result;
+}
\ No newline at end of file
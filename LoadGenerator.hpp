@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "LatencyHistogram.hpp"
+
+// Client of ContainerServer sending pipelined batches of random requests over one connection.
+// Latency is the round trip of a whole batch, from its write until its last response arrives.
+class LoadGenerator
+{
+    int fd = -1;
+
+public:
+    // Whole batch is written before reading, larger ones could fill both socket buffers
+    static constexpr std::size_t MAX_PIPELINE = 1 << 16;
+
+    struct Options
+    {
+        std::size_t requests = 1'000'000;
+        // Requests written at once before waiting for their responses
+        std::size_t pipeline = 64;
+        // Values are drawn from [0, keyRange)
+        std::int32_t keyRange = 1'000'000;
+        // Operation percentages
+        unsigned contains = 90;
+        unsigned add = 5;
+        unsigned remove = 5;
+        unsigned seed = 1;
+    };
+
+    struct Result
+    {
+        std::size_t requests = 0;
+        std::size_t hits = 0;
+        double seconds = 0;
+        // Batch round trips in nanoseconds
+        LatencyHistogram latency;
+    };
+
+    // Throws std::runtime_error when the server cannot be reached, Linux only
+    LoadGenerator(const std::string &path);
+    ~LoadGenerator();
+
+    LoadGenerator(const LoadGenerator &) = delete;
+    LoadGenerator &operator=(const LoadGenerator &) = delete;
+
+    Result run(const Options &options);
+};
\ No newline at end of file
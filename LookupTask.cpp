@@ -0,0 +1,100 @@
+#include "LookupTask.hpp"
+
+#ifdef INTERLEAVED_LOOKUP
+#include <new>
+#include <utility>
+#include <vector>
+
+// Freed frames of the last size seen, per thread so no locking is needed
+struct FrameCache
+{
+    static constexpr std::size_t LIMIT = 256;
+
+    std::size_t size = 0;
+    std::vector<void *> frames;
+
+    ~FrameCache()
+    {
+        for (void *frame : frames)
+            ::operator delete(frame);
+    }
+};
+
+static thread_local FrameCache frameCache;
+
+LookupTask LookupTask::promise_type::get_return_object()
+{
+    return LookupTask(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+void LookupTask::promise_type::unhandled_exception()
+{
+    // Leaves through resume(), the task counts as done
+    throw;
+}
+
+void *LookupTask::promise_type::operator new(std::size_t size)
+{
+    if (size == frameCache.size && !frameCache.frames.empty()) {
+        void *frame = frameCache.frames.back();
+        frameCache.frames.pop_back();
+        return frame;
+    }
+
+    return ::operator new(size);
+}
+
+void LookupTask::promise_type::operator delete(void *frame, std::size_t size)
+{
+    if (frameCache.size != size && frameCache.frames.empty())
+        frameCache.size = size;
+
+    if (frameCache.size == size && frameCache.frames.size() < FrameCache::LIMIT) {
+        frameCache.frames.push_back(frame);
+        return;
+    }
+
+    ::operator delete(frame);
+}
+
+LookupTask::LookupTask(std::coroutine_handle<promise_type> handle) : handle(handle)
+{
+}
+
+LookupTask::~LookupTask()
+{
+    if (handle)
+        handle.destroy();
+}
+
+LookupTask::LookupTask(LookupTask &&other) noexcept : handle(std::exchange(other.handle, nullptr))
+{
+}
+
+LookupTask &LookupTask::operator=(LookupTask &&other) noexcept
+{
+    if (this != &other) {
+        if (handle)
+            handle.destroy();
+        handle = std::exchange(other.handle, nullptr);
+    }
+
+    return *this;
+}
+
+void LookupTask::resume()
+{
+    handle.resume();
+}
+
+bool LookupTask::done() const
+{
+    return handle.done();
+}
+
+LookupTask::operator bool() const
+{
+    return (bool)handle;
+}
+
+#endif // INTERLEAVED_LOOKUP
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+
+// Coroutines need C++20, build with -std=c++20 to get interleaved lookups
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+
+#define INTERLEAVED_LOOKUP
+
+// One lookup running as a coroutine. It starts suspended and suspends again
+// after every prefetch, the scheduler resumes it until done()
+class LookupTask
+{
+public:
+    struct promise_type
+    {
+        LookupTask get_return_object();
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception();
+
+        // Frames of one traversal are all the same size, freed ones are reused
+        static void *operator new(std::size_t size);
+        static void operator delete(void *frame, std::size_t size);
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    LookupTask(std::coroutine_handle<promise_type> handle);
+
+public:
+    LookupTask() = default;
+    ~LookupTask();
+
+    LookupTask(LookupTask &&other) noexcept;
+    LookupTask &operator=(LookupTask &&other) noexcept;
+
+    // Runs the lookup up to its next suspension
+    void resume();
+    bool done() const;
+
+    explicit operator bool() const;
+};
+
+// Prefetches the node a lookup reads next and lets other lookups run while it loads
+struct PrefetchAwaiter
+{
+    const void *address;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<>) const noexcept { __builtin_prefetch(address); }
+    void await_resume() const noexcept {}
+};
+
+#endif // __cpp_impl_coroutine
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif // __unix__ || __APPLE__
+
+MappedFile::MappedFile(const std::string &path)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open file " + path + "!");
+
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot read file " + path + "!");
+    }
+
+    length = status.st_size;
+
+    // Mapping of an empty file fails, it has no contents anyway
+    if (length == 0) {
+        close(fd);
+        return;
+    }
+
+    void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (address == MAP_FAILED)
+        throw std::runtime_error("Cannot map file " + path + "!");
+
+    // File is parsed front to back, let the kernel read ahead
+    madvise(address, length, MADV_SEQUENTIAL);
+
+    contents = (const char *)address;
+    mapped = true;
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Cannot open file " + path + "!");
+
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    contents = buffer.data();
+    length = buffer.size();
+#endif // __unix__ || __APPLE__
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    if (mapped)
+        munmap((void *)contents, length);
+#endif // __unix__ || __APPLE__
+}
+
+const char *MappedFile::data() const
+{
+    return contents;
+}
+
+std::size_t MappedFile::size() const
+{
+    return length;
+}
\ No newline at end of file
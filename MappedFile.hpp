@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only contents of a whole file, memory mapped on POSIX systems and read in one go elsewhere
+class MappedFile
+{
+    const char *contents = nullptr;
+    std::size_t length = 0;
+    bool mapped = false;
+    std::string buffer;
+
+public:
+    // Throws std::runtime_error when the file cannot be opened or read
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const;
+    std::size_t size() const;
+};
\ No newline at end of file
@@ -8,38 +8,51 @@
 #include "List.hpp"
 #include "RBTree.hpp"
 #include "AVLTree.hpp"
+#include "ValueLoader.hpp"
+#include "OutputBuffer.hpp"
+#include "TokenReader.hpp"
+#include "ContainerServer.hpp"
+#include "LoadGenerator.hpp"
 #include "TimeBench.cpp"
 
 using namespace std;
 
 typedef int datatype;
 
-const string commonOperations = "r - read from file\na - add value\nx - remove value\nc - search if value exists\np - print container contents\nq - quit\n";
+const string commonOperations = "r - read from file\ns - stream from file while adding\nw - save binary snapshot\no - load binary snapshot\na - add value\nx - remove value\nc - search if value exists\np - print container contents\nd - dump contents to file without colors\nq - quit\n";
 
-vector<datatype> readFromFile()
+string getFileNameFromUser()
 {
     string fileName;
 
     cout << "Enter file name\n";
     cin >> fileName;
 
-    ifstream file(fileName);
-    if (!file.is_open())
-        throw std::runtime_error("nope");
+    return fileName;
+}
 
-    vector<datatype> values;
-    size_t len;
-    file >> len;
+vector<datatype> readFromFile()
+{
+    LoadStats stats;
+    vector<datatype> values = loadValues<datatype>(getFileNameFromUser(), &stats);
 
-    for (; len > 0; len--) {
-        datatype val;
-        file >> val;
-        values.push_back(val);
-    }
+    cout << "Loaded " << values.size() << " values, " << stats.bytes / 1024 << "KB in "
+        << stats.seconds * 1000 << "ms (" << stats.megabytesPerSecond() << " MB/s)\n";
 
     return values;
 }
 
+// Values are added while the file is still being parsed, without buffering all of them
+template <typename F>
+void streamFromFile(F &&consume)
+{
+    LoadStats stats;
+    size_t count = streamValues<datatype>(getFileNameFromUser(), consume, &stats);
+
+    cout << "Added " << count << " values, " << stats.bytes / 1024 << "KB in "
+        << stats.seconds * 1000 << "ms (" << stats.megabytesPerSecond() << " MB/s)\n";
+}
+
 datatype getDataFromUser()
 {
     datatype val;
@@ -83,6 +96,9 @@ repeat:
             container.add(val);
         break;
     }
+    case 's':
+        streamFromFile([&](datatype val) { container.add(val); });
+        break;
     case 'a': {
         container.add(getDataFromUser());
         break;
@@ -93,6 +109,18 @@ repeat:
     case 'c':
         cout << container.contains(getDataFromUser()) << endl;
         break;
+    case 'w':
+        container.save(getFileNameFromUser());
+        break;
+    case 'o':
+        container.load(getFileNameFromUser());
+        break;
+    case 'd': {
+        OutputBuffer output(getFileNameFromUser());
+        container.dump(output, true);
+        output.flush();
+        break;
+    }
     case 'p':
         container.print();
         std::cin.get();
@@ -120,6 +148,9 @@ repeat:
             container.add(val);
         break;
     }
+    case 's':
+        streamFromFile([&](datatype val) { container.add(val); });
+        break;
     case 'a': {
         container.add(getDataFromUser());
         break;
@@ -130,6 +161,18 @@ repeat:
     case 'c':
         cout << container.contains(getDataFromUser()) << endl;
         break;
+    case 'w':
+        container.save(getFileNameFromUser());
+        break;
+    case 'o':
+        container.load(getFileNameFromUser());
+        break;
+    case 'd': {
+        OutputBuffer output(getFileNameFromUser());
+        container.dump(output, true);
+        output.flush();
+        break;
+    }
     case 'p':
         container.print();
         std::cin.get();
@@ -161,6 +204,9 @@ repeat:
             container.push_back(val);
         break;
     }
+    case 's':
+        streamFromFile([&](datatype val) { container.push_back(val); });
+        break;
     case 'a': {
         container.push_back(getDataFromUser());
         break;
@@ -187,6 +233,18 @@ repeat:
     case 'u':
         container.pop_back();
         break;
+    case 'w':
+        container.save(getFileNameFromUser());
+        break;
+    case 'o':
+        container.load(getFileNameFromUser());
+        break;
+    case 'd': {
+        OutputBuffer output(getFileNameFromUser());
+        container.dump(output, true);
+        output.flush();
+        break;
+    }
     case 'p':
         container.print();
         std::cin.get();
@@ -218,6 +276,9 @@ repeat:
             container.push_back(val);
         break;
     }
+    case 's':
+        streamFromFile([&](datatype val) { container.push_back(val); });
+        break;
     case 'a': {
         container.push_back(getDataFromUser());
         break;
@@ -244,6 +305,18 @@ repeat:
     case 'u':
         container.pop_back();
         break;
+    case 'w':
+        container.save(getFileNameFromUser());
+        break;
+    case 'o':
+        container.load(getFileNameFromUser());
+        break;
+    case 'd': {
+        OutputBuffer output(getFileNameFromUser());
+        container.dump(output, true);
+        output.flush();
+        break;
+    }
     case 'p':
         container.print();
         std::cin.get();
@@ -271,6 +344,9 @@ repeat:
             container.add(val);
         break;
     }
+    case 's':
+        streamFromFile([&](datatype val) { container.add(val); });
+        break;
     case 'a':
         container.add(getDataFromUser());
         break;
@@ -280,6 +356,18 @@ repeat:
     case 'c':
         cout << container.contains(getDataFromUser()) << endl;
         break;
+    case 'w':
+        container.save(getFileNameFromUser());
+        break;
+    case 'o':
+        container.load(getFileNameFromUser());
+        break;
+    case 'd': {
+        OutputBuffer output(getFileNameFromUser());
+        container.dump(output, true);
+        output.flush();
+        break;
+    }
     case 'p':
         container.print();
         std::cin.get();
@@ -289,11 +377,494 @@ repeat:
     goto repeat;
 }
 
-int main()
+const string benchmarkUsage =
+    "Usage: sdizo [options]\n"
+    "  --containers=A,B    containers to test (Array, List, BinHeap, RBTree, AVLTree,\n"
+    "                      PersistentRBTree, Treap, PairingHeap, RadixHeap,\n"
+    "                      RBMap, AVLMap with string keys)\n"
+    "  --ops=A,B           operations to test (e.g. add, contains, remove, push_pop, erase_range)\n"
+    "  --sizes=N,M         dataset sizes\n"
+    "  --keys=A,B          key distributions (uniform, sorted, reverse, nearly_sorted, zipf, clustered, duplicates)\n"
+    "  --access=A,B        access patterns of search and remove (random, insertion, sorted, zipf)\n"
+    "  --mix=C:A:R,...     contains:add:remove percentages of mixed workloads, default 90:5:5\n"
+    "  --trace=FILE        replay a/x/c operations from file on every container\n"
+    "  --datasets=N        datasets generated per suite\n"
+    "  --loops=N           measurement loops per dataset\n"
+    "  --budget=MS         time budget per suite in milliseconds\n"
+    "  --seed=N            random generator seed\n"
+    "  --linear-cutoff=N   largest size tested with linear time containers\n"
+    "  --batch             time batches of operations instead of single ones\n"
+    "  --clock=chrono|tsc  clock source\n"
+    "  --perf              count hardware events per operation (Linux perf_event_open)\n"
+    "  --memory            count heap allocations per operation and bytes per element\n"
+    "  --jobs=N            run suites on N pinned threads, 0 uses all selected CPUs\n"
+    "  --cpus=LIST         CPUs for the threads (e.g. 2-5,8) or isolated for isolcpus ones\n"
+    "  --format=text|csv|json\n"
+    "  --output=FILE       write results to file instead of stdout\n"
+    "  --compare=FILE      compare with CSV results of a previous run\n";
+
+vector<string> splitList(const string &list)
+{
+    vector<string> items;
+    size_t start = 0;
+
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == string::npos)
+            end = list.size();
+
+        if (end > start)
+            items.push_back(list.substr(start, end - start));
+        start = end + 1;
+    }
+
+    return items;
+}
+
+// Command line option as --name=value, value is empty without '='
+struct CommandLineArgument
+{
+    string text;
+    string name;
+    string value;
+};
+
+vector<CommandLineArgument> splitArguments(int argc, char **argv)
+{
+    vector<CommandLineArgument> arguments;
+
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        size_t separator = argument.find('=');
+
+        arguments.push_back({ argument, argument.substr(0, separator),
+                              separator == string::npos ? "" : argument.substr(separator + 1) });
+    }
+
+    return arguments;
+}
+
+// Passed to the callback of withContainer, type names the selected container
+template <typename C>
+struct ContainerType
+{
+    using type = C;
+};
+
+// Calls run with the ContainerType of the container named ignoring case and returns its result,
+// containers of the script and server modes
+template <typename F>
+auto withContainer(const string &name, F &&run)
+{
+    if (TimeBenchmark::equalIgnoreCase(name, "Array"))
+        return run(ContainerType<Array<datatype>>());
+    if (TimeBenchmark::equalIgnoreCase(name, "List"))
+        return run(ContainerType<List<datatype>>());
+    if (TimeBenchmark::equalIgnoreCase(name, "BinHeap"))
+        return run(ContainerType<BinHeap<datatype>>());
+    if (TimeBenchmark::equalIgnoreCase(name, "RBTree"))
+        return run(ContainerType<RBTree<datatype>>());
+    if (TimeBenchmark::equalIgnoreCase(name, "AVLTree"))
+        return run(ContainerType<AVLTree<datatype>>());
+
+    throw std::invalid_argument("unknown container " + name);
+}
+
+// Runs the benchmark configured from command line, bypassing the menu
+int benchmarkFromArguments(int argc, char **argv)
+{
+    vector<string> containers, operations;
+    vector<size_t> sizes;
+    vector<KeyDistribution> distributions = { KeyDistribution::UNIFORM };
+    vector<AccessPattern> patterns = { AccessPattern::RANDOM };
+    vector<TimeBenchmark::OperationMix> mixes = { { 90, 5, 5 } };
+    string tracePath;
+    size_t datasets = 100, loops = 10;
+    size_t budget = 0, linearCutoff = 25'000;
+    bool seedSet = false;
+    bool perfCounters = false;
+    bool memory = false;
+    size_t jobs = 1;
+    vector<int> cpus;
+    unsigned seed = 0;
+    auto timingMode = TimeBenchmark::TimingMode::PER_OPERATION;
+    auto clockSource = TimeBenchmark::ClockSource::CHRONO;
+    auto format = TimeBenchmark::OutputFormat::TEXT;
+    string outputPath, comparePath;
+
+    try {
+        for (const auto &[argument, name, value] : splitArguments(argc, argv)) {
+            if (name == "--containers")
+                containers = splitList(value);
+            else if (name == "--ops")
+                operations = splitList(value);
+            else if (name == "--sizes") {
+                sizes.clear();
+                for (const auto &size : splitList(value))
+                    sizes.push_back(stoul(size));
+            }
+            else if (name == "--keys") {
+                distributions.clear();
+                for (const auto &item : splitList(value))
+                    distributions.push_back(parseWorkloadName<KeyDistribution>(item));
+            }
+            else if (name == "--access") {
+                patterns.clear();
+                for (const auto &item : splitList(value))
+                    patterns.push_back(parseWorkloadName<AccessPattern>(item));
+            }
+            else if (name == "--mix") {
+                mixes.clear();
+                for (const auto &item : splitList(value))
+                    mixes.push_back(TimeBenchmark::parseOperationMix(item));
+            }
+            else if (name == "--trace")
+                tracePath = value;
+            else if (name == "--datasets")
+                datasets = stoul(value);
+            else if (name == "--loops")
+                loops = stoul(value);
+            else if (name == "--budget")
+                budget = stoul(value);
+            else if (name == "--seed") {
+                seed = stoul(value);
+                seedSet = true;
+            }
+            else if (name == "--linear-cutoff")
+                linearCutoff = stoul(value);
+            else if (name == "--perf")
+                perfCounters = true;
+            else if (name == "--memory")
+                memory = true;
+            else if (name == "--jobs")
+                jobs = stoul(value);
+            else if (name == "--cpus" && value == "isolated") {
+                cpus = CpuAffinity::isolated();
+                if (cpus.empty())
+                    throw std::runtime_error("No isolated CPUs, boot with isolcpus=LIST");
+            }
+            else if (name == "--cpus")
+                cpus = CpuAffinity::parseList(value);
+            else if (name == "--batch")
+                timingMode = TimeBenchmark::TimingMode::BATCH;
+            else if (name == "--clock" && (value == "chrono" || value == "tsc"))
+                clockSource = value == "tsc" ? TimeBenchmark::ClockSource::TSC : TimeBenchmark::ClockSource::CHRONO;
+            else if (name == "--format" && value == "text")
+                format = TimeBenchmark::OutputFormat::TEXT;
+            else if (name == "--format" && value == "csv")
+                format = TimeBenchmark::OutputFormat::CSV;
+            else if (name == "--format" && value == "json")
+                format = TimeBenchmark::OutputFormat::JSON;
+            else if (name == "--output")
+                outputPath = value;
+            else if (name == "--compare")
+                comparePath = value;
+            else if (name == "--help" || name == "-h") {
+                cout << benchmarkUsage;
+                return 0;
+            }
+            else
+                throw std::invalid_argument(argument);
+        }
+
+        if (datasets == 0 || loops == 0)
+            throw std::invalid_argument("repetition count must be positive");
+        if (distributions.empty() || patterns.empty())
+            throw std::invalid_argument("workload list is empty");
+
+        TimeBenchmark bench(timingMode, clockSource);
+
+        if (!sizes.empty())
+            bench.setDatasetSizes(sizes);
+        bench.setRepetitions(datasets, loops);
+        bench.setWorkloads(distributions, patterns);
+        bench.setOperationMixes(mixes);
+        if (!tracePath.empty())
+            bench.setTrace(tracePath);
+        bench.setTimeBudget(budget);
+        bench.setLinearCutoff(linearCutoff);
+        bench.setFilter(containers, operations);
+        bench.setOutput(format, outputPath);
+        bench.setPerfCounters(perfCounters);
+        bench.setAllocationCounting(memory);
+        bench.setJobs(jobs);
+        bench.setCpus(cpus);
+        if (seedSet)
+            bench.setSeed(seed);
+        if (!comparePath.empty())
+            bench.setCompareBaseline(comparePath);
+
+        return bench.run() ? 1 : 0;
+    }
+    catch (const std::logic_error &error) {
+        // Thrown by stoul and for unknown options or names
+        cerr << "Invalid argument: " << error.what() << "\n" << benchmarkUsage;
+        return 2;
+    }
+    catch (const std::runtime_error &error) {
+        cerr << "Error: " << error.what() << "\n";
+        return 1;
+    }
+}
+
+const string scriptUsage =
+    "Usage: sdizo --script=FILE|- --container=NAME\n"
+    "  --container=NAME    Array, List, BinHeap, RBTree or AVLTree\n"
+    "Commands, one per line, results of c are written one per line:\n"
+    "  a V, x V, c V       add, remove, contains\n"
+    "  load FILE           add values of a text file, stream FILE adds them while parsing\n"
+    "  save FILE, open FILE  binary snapshot\n"
+    "  p                   print container without colors\n";
+
+// Array and List have no add, values are appended like in their menus
+template <typename C>
+void scriptAdd(C &container, datatype val)
 {
+    container.add(val);
+}
+
+void scriptAdd(Array<datatype> &container, datatype val)
+{
+    container.push_back(val);
+}
+
+void scriptAdd(List<datatype> &container, datatype val)
+{
+    container.push_back(val);
+}
+
+// Runs commands against the container, returns number of executed commands
+template <typename C>
+size_t runScript(C &container, TokenReader &script, OutputBuffer &output)
+{
+    const char *first, *last;
+    size_t commands = 0;
+
+    auto argument = [&]() {
+        if (!script.next(first, last))
+            throw std::runtime_error("Missing argument of command " + to_string(commands + 1) + "!");
+        return string(first, last);
+    };
+
+    auto value = [&]() {
+        datatype val;
+        if (!script.next(first, last) || parseValue(first, last, val) != last)
+            throw std::runtime_error("Invalid value of command " + to_string(commands + 1) + "!");
+        return val;
+    };
+
+    while (script.next(first, last)) {
+        string_view command(first, last - first);
+
+        if (command == "a")
+            scriptAdd(container, value());
+        else if (command == "x")
+            container.remove(value());
+        else if (command == "c") {
+            output.put(container.contains(value()) ? '1' : '0');
+            output.put('\n');
+        }
+        else if (command == "load") {
+            for (auto val : loadValues<datatype>(argument()))
+                scriptAdd(container, val);
+        }
+        else if (command == "stream")
+            streamValues<datatype>(argument(), [&](datatype val) { scriptAdd(container, val); });
+        else if (command == "save")
+            container.save(argument());
+        else if (command == "open")
+            container.load(argument());
+        else if (command == "p")
+            container.dump(output, true);
+        else
+            throw std::runtime_error("Unknown command " + string(command) + "!");
+
+        commands++;
+    }
+
+    return commands;
+}
+
+template <typename C>
+size_t runScript(const string &path, OutputBuffer &output)
+{
+    C container;
+    TokenReader script(path == "-" ? "/dev/stdin" : path);
+
+    return runScript(container, script, output);
+}
+
+// Executes a command file without prompts, the fast path for piped automation
+int scriptFromArguments(int argc, char **argv)
+{
+    string scriptPath, containerName;
+
+    try {
+        for (const auto &[argument, name, value] : splitArguments(argc, argv)) {
+            if (name == "--script")
+                scriptPath = value;
+            else if (name == "--container")
+                containerName = value;
+            else
+                throw std::invalid_argument(argument);
+        }
+
+        if (scriptPath.empty())
+            throw std::invalid_argument("missing script");
+
+        OutputBuffer output;
+        auto start = chrono::steady_clock::now();
+
+        size_t commands = withContainer(containerName, [&](auto container) {
+            return runScript<typename decltype(container)::type>(scriptPath, output);
+        });
+
+        output.flush();
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cerr << commands << " commands in " << seconds * 1000 << "ms ("
+            << (seconds > 0 ? commands / seconds / 1'000'000 : 0) << " Mops/s)\n";
+
+        return 0;
+    }
+    catch (const std::logic_error &error) {
+        cerr << "Invalid argument: " << error.what() << "\n" << scriptUsage;
+        return 2;
+    }
+    catch (const std::runtime_error &error) {
+        cerr << "Error: " << error.what() << "\n";
+        return 1;
+    }
+}
+
+const string serverUsage =
+    "Usage: sdizo --serve=SOCKET --container=NAME [--load=FILE] [--open=SNAPSHOT]\n"
+    "       sdizo --client=SOCKET [--requests=N] [--pipeline=N] [--range=N] [--mix=C:A:R] [--seed=N]\n"
+    "  --serve=SOCKET      keep the container in memory and answer requests on a Unix socket\n"
+    "  --load, --open      fill the container from a text file or a binary snapshot first\n"
+    "  --client=SOCKET     send random pipelined requests and report throughput and latency\n";
+
+template <typename C>
+int serveContainer(const string &socketPath, const string &loadPath, const string &snapshotPath)
+{
+    C container;
+
+    if (!snapshotPath.empty())
+        container.load(snapshotPath);
+    if (!loadPath.empty())
+        streamValues<datatype>(loadPath, [&](datatype val) { scriptAdd(container, val); });
+
+    ContainerServer server(socketPath, [&](const ServerRequest *requests, size_t count, uint8_t *responses) {
+        for (size_t i = 0; i < count; i++) {
+            switch (requests[i].operation) {
+            case SERVER_ADD:
+                scriptAdd(container, requests[i].value);
+                responses[i] = SERVER_TRUE;
+                break;
+            case SERVER_REMOVE:
+                responses[i] = container.remove(requests[i].value) ? SERVER_TRUE : SERVER_FALSE;
+                break;
+            case SERVER_CONTAINS:
+                responses[i] = container.contains(requests[i].value) ? SERVER_TRUE : SERVER_FALSE;
+                break;
+            default:
+                responses[i] = SERVER_UNKNOWN_OPERATION;
+            }
+        }
+    });
+
+    cerr << "Serving on " << socketPath << ", stop with Ctrl+C\n";
+    server.run();
+
+    return 0;
+}
+
+// Server keeping one container resident and its load generating client
+int serverFromArguments(int argc, char **argv)
+{
+    string socketPath, containerName = "RBTree", loadPath, snapshotPath;
+    bool client = false;
+    LoadGenerator::Options options;
+
+    try {
+        for (const auto &[argument, name, value] : splitArguments(argc, argv)) {
+            if (name == "--serve" || name == "--client") {
+                socketPath = value;
+                client = name == "--client";
+            }
+            else if (name == "--container")
+                containerName = value;
+            else if (name == "--load")
+                loadPath = value;
+            else if (name == "--open")
+                snapshotPath = value;
+            else if (name == "--requests")
+                options.requests = stoul(value);
+            else if (name == "--pipeline")
+                options.pipeline = stoul(value);
+            else if (name == "--range")
+                options.keyRange = stoi(value);
+            else if (name == "--seed")
+                options.seed = stoul(value);
+            else if (name == "--mix") {
+                auto mix = TimeBenchmark::parseOperationMix(value);
+                options.contains = mix.contains;
+                options.add = mix.add;
+                options.remove = mix.remove;
+            }
+            else
+                throw std::invalid_argument(argument);
+        }
+
+        if (socketPath.empty())
+            throw std::invalid_argument("missing socket path");
+
+        if (client) {
+            LoadGenerator generator(socketPath);
+            auto result = generator.run(options);
+
+            cout << result.requests << " requests in " << result.seconds * 1000 << "ms ("
+                << (result.seconds > 0 ? result.requests / result.seconds / 1'000'000 : 0) << " Mops/s), "
+                << result.hits << " hits\n"
+                << "Batch of " << options.pipeline << " round trip: p50 " << result.latency.percentile(50)
+                << "ns, p99 " << result.latency.percentile(99) << "ns, p99.9 " << result.latency.percentile(99.9)
+                << "ns, max " << result.latency.max() << "ns\n";
+            return 0;
+        }
+
+        return withContainer(containerName, [&](auto container) {
+            return serveContainer<typename decltype(container)::type>(socketPath, loadPath, snapshotPath);
+        });
+    }
+    catch (const std::logic_error &error) {
+        cerr << "Invalid argument: " << error.what() << "\n" << serverUsage;
+        return 2;
+    }
+    catch (const std::runtime_error &error) {
+        cerr << "Error: " << error.what() << "\n";
+        return 1;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+
+        if (argument.compare(0, 8, "--script") == 0)
+            return scriptFromArguments(argc, argv);
+        if (argument.compare(0, 7, "--serve") == 0 || argument.compare(0, 8, "--client") == 0)
+            return serverFromArguments(argc, argv);
+    }
+
+    if (argc > 1)
+        return benchmarkFromArguments(argc, argv);
+
     char input;
     cout << "SDiZO Projekt 1.\n"
         << "b - test automatyczny kontenerów\n"
+        << "s - test automatyczny kontenerów, pomiar seriami operacji\n"
+        << "e - test automatyczny kontenerów, wyniki do pliku CSV/JSON\n"
         << "m - test manualny\n";
     input = getOptionFromUser();
 
@@ -303,6 +874,30 @@ int main()
         return 0;
     }
 
+    if (input == 's') {
+        TimeBenchmark bench(TimeBenchmark::TimingMode::BATCH, TimeBenchmark::ClockSource::TSC);
+        bench.run();
+        return 0;
+    }
+
+    if (input == 'e') {
+        string outputPath, comparePath;
+
+        cout << "Podaj plik wynikow (.csv lub .json)\n";
+        cin >> outputPath;
+        cout << "Podaj plik CSV z poprzednimi wynikami do porownania lub -\n";
+        cin >> comparePath;
+
+        bool json = outputPath.size() >= 5 && outputPath.compare(outputPath.size() - 5, 5, ".json") == 0;
+
+        TimeBenchmark bench;
+        bench.setOutput(json ? TimeBenchmark::OutputFormat::JSON : TimeBenchmark::OutputFormat::CSV, outputPath);
+        if (comparePath != "-")
+            bench.setCompareBaseline(comparePath);
+
+        return bench.run() ? 1 : 0;
+    }
+
     cout << "Wybierz strukture:\n"
         << "h - BinHeap\n"
         << "a - Array\n"
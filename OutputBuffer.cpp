@@ -0,0 +1,76 @@
+#include "OutputBuffer.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+OutputBuffer::OutputBuffer(std::FILE *stream, std::size_t capacity) : stream(stream), buffer(capacity)
+{
+}
+
+OutputBuffer::OutputBuffer(const std::string &path, std::size_t capacity) :
+    stream(std::fopen(path.c_str(), "wb")), ownsStream(true), buffer(capacity)
+{
+    if (!stream)
+        throw std::runtime_error("Cannot create file " + path + "!");
+}
+
+OutputBuffer::~OutputBuffer()
+{
+    if (used)
+        std::fwrite(buffer.data(), 1, used, stream);
+
+    if (ownsStream)
+        std::fclose(stream);
+    else
+        std::fflush(stream);
+}
+
+void OutputBuffer::put(char character)
+{
+    if (used == buffer.size())
+        flush();
+
+    buffer[used++] = character;
+}
+
+void OutputBuffer::write(const char *data, std::size_t size)
+{
+    if (size > buffer.size() - used)
+        flush();
+
+    // Larger blocks skip the buffer
+    if (size > buffer.size()) {
+        if (std::fwrite(data, 1, size, stream) != size)
+            throw std::runtime_error("Cannot write output!");
+        return;
+    }
+
+    std::memcpy(buffer.data() + used, data, size);
+    used += size;
+}
+
+void OutputBuffer::write(const std::string &text)
+{
+    write(text.data(), text.size());
+}
+
+void OutputBuffer::writeInteger(long long value)
+{
+    // Longest value is 20 characters with the sign
+    if (buffer.size() - used < 20)
+        flush();
+
+    used = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), value).ptr - buffer.data();
+}
+
+void OutputBuffer::flush()
+{
+    if (used && std::fwrite(buffer.data(), 1, used, stream) != used)
+        throw std::runtime_error("Cannot write output!");
+
+    used = 0;
+
+    if (std::fflush(stream) != 0)
+        throw std::runtime_error("Cannot write output!");
+}
\ No newline at end of file
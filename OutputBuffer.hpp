@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Collects output in memory and writes it to the stream in large blocks.
+// Numbers are formatted with std::to_chars, without locales or iostreams.
+class OutputBuffer
+{
+    std::FILE *stream;
+    bool ownsStream = false;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+
+public:
+    OutputBuffer(std::FILE *stream = stdout, std::size_t capacity = 1 << 16);
+    // Writes to a new file, throws std::runtime_error when it cannot be created
+    OutputBuffer(const std::string &path, std::size_t capacity = 1 << 16);
+    // Flushes remaining output, errors are ignored here
+    ~OutputBuffer();
+
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+    void put(char character);
+    void write(const char *data, std::size_t size);
+    void write(const std::string &text);
+    void writeInteger(long long value);
+
+    // Integers are formatted with writeInteger, other types with their operator<<
+    template <typename T>
+    void writeValue(const T &value)
+    {
+        if constexpr (std::is_integral<T>::value)
+            writeInteger(value);
+        else {
+            std::ostringstream text;
+            text << value;
+            write(text.str());
+        }
+    }
+
+    // Throws std::runtime_error when the stream rejects the output
+    void flush();
+};
\ No newline at end of file
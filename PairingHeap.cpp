@@ -0,0 +1,280 @@
+#pragma once
+
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+
+#include "PairingHeap.hpp"
+
+template <typename T, typename Compare>
+PairingHeap<T, Compare>::PairingHeap(const Compare &comp) : comp(comp)
+{
+}
+
+template <typename T, typename Compare>
+PairingHeap<T, Compare>::~PairingHeap()
+{
+    if (!root)
+        return;
+
+    // Tree can be very wide and deep, avoid recursion
+    std::queue<Node *> nodes;
+    nodes.push(root);
+
+    while (!nodes.empty()) {
+        Node *node = nodes.front();
+        nodes.pop();
+
+        if (node->child)
+            nodes.push(node->child);
+        if (node->sibling)
+            nodes.push(node->sibling);
+
+        delete node;
+    }
+}
+
+template <typename T, typename Compare>
+auto PairingHeap<T, Compare>::link(Node *first, Node *second) -> Node *
+{
+    // Both nodes are roots, the one ordered lower becomes the leftmost child of the other
+    if (comp(first->value, second->value))
+        std::swap(first, second);
+
+    second->sibling = first->child;
+    if (first->child)
+        first->child->prev = second;
+
+    second->prev = first;
+    first->child = second;
+
+    return first;
+}
+
+template <typename T, typename Compare>
+auto PairingHeap<T, Compare>::merge_pairs(Node *first) -> Node *
+{
+    if (!first)
+        return nullptr;
+
+    // First pass, link subtrees in pairs from left to right
+    // Results are chained in reverse order through sibling pointers
+    Node *pairs = nullptr;
+
+    while (first) {
+        Node *a = first;
+        Node *b = a->sibling;
+
+        a->prev = nullptr;
+
+        if (!b) {
+            a->sibling = pairs;
+            pairs = a;
+            break;
+        }
+
+        first = b->sibling;
+
+        a->sibling = nullptr;
+        b->sibling = nullptr;
+        b->prev = nullptr;
+
+        Node *merged = link(a, b);
+        merged->sibling = pairs;
+        pairs = merged;
+    }
+
+    // Second pass, link the results from right to left
+    Node *result = pairs;
+    pairs = pairs->sibling;
+    result->sibling = nullptr;
+
+    while (pairs) {
+        Node *next = pairs->sibling;
+        pairs->sibling = nullptr;
+
+        result = link(result, pairs);
+        pairs = next;
+    }
+
+    return result;
+}
+
+template <typename T, typename Compare>
+void PairingHeap<T, Compare>::cut(Node *node)
+{
+    // Detach node together with its subtree
+    if (node->prev->child == node)
+        node->prev->child = node->sibling;
+    else
+        node->prev->sibling = node->sibling;
+
+    if (node->sibling)
+        node->sibling->prev = node->prev;
+
+    node->prev = nullptr;
+    node->sibling = nullptr;
+}
+
+template <typename T, typename Compare>
+auto PairingHeap<T, Compare>::add(const T &value) -> Node *
+{
+    Node *node = new Node();
+    node->value = value;
+
+    root = root ? link(root, node) : node;
+    count++;
+
+    return node;
+}
+
+template <typename T, typename Compare>
+const T &PairingHeap<T, Compare>::top() const
+{
+    if (!root)
+        throw std::out_of_range("Heap is empty");
+
+    return root->value;
+}
+
+template <typename T, typename Compare>
+void PairingHeap<T, Compare>::pop()
+{
+    if (!root)
+        return;
+
+    Node *old_root = root;
+    root = merge_pairs(root->child);
+    count--;
+
+    delete old_root;
+}
+
+template <typename T, typename Compare>
+void PairingHeap<T, Compare>::meld(PairingHeap &other)
+{
+    if (&other == this || !other.root)
+        return;
+
+    root = root ? link(root, other.root) : other.root;
+    count += other.count;
+
+    other.root = nullptr;
+    other.count = 0;
+}
+
+template <typename T, typename Compare>
+void PairingHeap<T, Compare>::decrease_key(Node *node, const T &value)
+{
+    if (!node)
+        throw std::runtime_error("Node is empty!");
+    if (comp(value, node->value))
+        throw std::runtime_error("New key is ordered below the current one");
+
+    node->value = value;
+
+    if (node == root)
+        return;
+
+    cut(node);
+    root = link(root, node);
+}
+
+template <typename T, typename Compare>
+bool PairingHeap<T, Compare>::remove(Node *node)
+{
+    if (!node)
+        return false;
+
+    if (node == root) {
+        pop();
+        return true;
+    }
+
+    cut(node);
+
+    Node *subheap = merge_pairs(node->child);
+    if (subheap)
+        root = link(root, subheap);
+
+    count--;
+    delete node;
+
+    return true;
+}
+
+template <typename T, typename Compare>
+bool PairingHeap<T, Compare>::remove(const T &value)
+{
+    return remove(find(value));
+}
+
+template <typename T, typename Compare>
+auto PairingHeap<T, Compare>::find(const T &value) const -> Node *
+{
+    if (!root)
+        return nullptr;
+
+    std::queue<Node *> nodes;
+    nodes.push(root);
+
+    while (!nodes.empty()) {
+        Node *node = nodes.front();
+        nodes.pop();
+
+        if (node->value == value)
+            return node;
+
+        // Subtree can't contain values ordered above its root
+        if (node->child && !comp(node->value, value))
+            nodes.push(node->child);
+        if (node->sibling)
+            nodes.push(node->sibling);
+    }
+
+    return nullptr;
+}
+
+template <typename T, typename Compare>
+bool PairingHeap<T, Compare>::contains(const T &value) const
+{
+    return find(value);
+}
+
+template <typename T, typename Compare>
+bool PairingHeap<T, Compare>::empty() const
+{
+    return !root;
+}
+
+template <typename T, typename Compare>
+const std::size_t &PairingHeap<T, Compare>::size() const
+{
+    return count;
+}
+
+template <typename T, typename Compare>
+void PairingHeap<T, Compare>::print() const
+{
+    if (!root)
+        return;
+
+    // Print every level of the tree in a separate row
+    std::queue<Node *> level, next_level;
+    level.push(root);
+
+    while (!level.empty()) {
+        for (Node *node = level.front(); node; node = node->sibling) {
+            std::cout << node->value << " ";
+
+            if (node->child)
+                next_level.push(node->child);
+        }
+        level.pop();
+
+        if (level.empty()) {
+            std::cout << std::endl;
+            std::swap(level, next_level);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Heap with O(1) add/meld/decrease_key and amortized O(log n) pop
+// Compare follows std::priority_queue, by default the smallest element is kept on top
+template <typename T, typename Compare = std::greater<T>>
+class PairingHeap
+{
+public:
+    struct Node
+    {
+        T value;
+        Node *child = nullptr;
+        Node *sibling = nullptr;
+
+        // Parent if node is the leftmost child, left sibling otherwise
+        Node *prev = nullptr;
+    };
+
+    PairingHeap(const Compare &comp = Compare());
+    ~PairingHeap();
+
+    // Returned handle stays valid until the node is removed
+    Node *add(const T &value);
+
+    // Element on top of the heap
+    const T &top() const;
+    // Remove the top element, does nothing if heap is empty
+    void pop();
+
+    // Move all elements of other heap into this one, other is left empty
+    void meld(PairingHeap &other);
+
+    // Move node towards the top, new value can't be ordered below the current one
+    void decrease_key(Node *node, const T &value);
+
+    bool remove(const T &value);
+    bool remove(Node *node);
+    bool contains(const T &value) const;
+
+    bool empty() const;
+    const std::size_t &size() const;
+    void print() const;
+
+private:
+    Node *root = nullptr;
+    std::size_t count = 0;
+    Compare comp;
+
+    Node *find(const T &value) const;
+
+    // Helpers
+    Node *link(Node *first, Node *second);
+    Node *merge_pairs(Node *first);
+    void cut(Node *node);
+};
+
+// For template explicit instantiations
+#include "PairingHeap.cpp"
\ No newline at end of file
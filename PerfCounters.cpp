@@ -0,0 +1,158 @@
+#include "PerfCounters.hpp"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // __linux__
+
+#ifdef __linux__
+static int openEvent(std::uint32_t type, std::uint64_t config)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // User space only, allowed with the default perf_event_paranoid setting
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static std::uint64_t cacheMissConfig(std::uint64_t cache)
+{
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+#endif // __linux__
+
+PerfCounters::PerfCounters()
+{
+    fds.fill(-1);
+    counts.fill(0);
+
+#ifdef __linux__
+    fds[CYCLES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    if (fds[CYCLES] < 0)
+        errorMessage = std::string("perf_event_open failed: ") + std::strerror(errno);
+
+    fds[INSTRUCTIONS] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds[L1D_MISSES] = openEvent(PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_L1D));
+    fds[LLC_MISSES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds[BRANCH_MISSES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    fds[DTLB_MISSES] = openEvent(PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_DTLB));
+
+    if (available())
+        errorMessage.clear();
+    else if (errorMessage.empty())
+        errorMessage = "no hardware events supported";
+#else
+    errorMessage = "performance counters are supported only on Linux";
+#endif // __linux__
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (auto fd : fds)
+        if (fd >= 0)
+            close(fd);
+#endif // __linux__
+}
+
+const char *PerfCounters::name(Event event)
+{
+    switch (event) {
+    case CYCLES:
+        return "cycles";
+    case INSTRUCTIONS:
+        return "instructions";
+    case L1D_MISSES:
+        return "l1d_misses";
+    case LLC_MISSES:
+        return "llc_misses";
+    case BRANCH_MISSES:
+        return "branch_misses";
+    case DTLB_MISSES:
+        return "dtlb_misses";
+    default:
+        return "";
+    }
+}
+
+bool PerfCounters::available() const
+{
+    for (auto fd : fds)
+        if (fd >= 0)
+            return true;
+
+    return false;
+}
+
+bool PerfCounters::available(Event event) const
+{
+    return fds[event] >= 0;
+}
+
+const std::string &PerfCounters::error() const
+{
+    return errorMessage;
+}
+
+bool PerfCounters::read(Event event, Reading &reading) const
+{
+#ifdef __linux__
+    std::uint64_t buffer[3];
+
+    if (fds[event] < 0 || ::read(fds[event], buffer, sizeof(buffer)) != sizeof(buffer))
+        return false;
+
+    reading.value = buffer[0];
+    reading.enabled = buffer[1];
+    reading.running = buffer[2];
+
+    return true;
+#else
+    return false;
+#endif // __linux__
+}
+
+void PerfCounters::start()
+{
+    for (int event = 0; event < EVENTS_COUNT; event++)
+        read((Event)event, startReadings[event]);
+}
+
+void PerfCounters::stop()
+{
+    Reading reading;
+
+    for (int event = 0; event < EVENTS_COUNT; event++) {
+        if (!read((Event)event, reading))
+            continue;
+
+        const Reading &start = startReadings[event];
+        std::uint64_t running = reading.running - start.running;
+
+        if (running == 0)
+            continue;
+
+        counts[event] += (double)(reading.value - start.value) * (reading.enabled - start.enabled) / running;
+    }
+}
+
+void PerfCounters::reset()
+{
+    counts.fill(0);
+}
+
+double PerfCounters::count(Event event) const
+{
+    return counts[event];
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Hardware event counters of the calling thread, read with perf_event_open on Linux.
+// Events that cannot be opened are reported as unavailable, other platforms have none.
+class PerfCounters
+{
+public:
+    enum Event
+    {
+        CYCLES,
+        INSTRUCTIONS,
+        L1D_MISSES,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        DTLB_MISSES,
+        EVENTS_COUNT
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    static const char *name(Event event);
+
+    bool available() const;
+    bool available(Event event) const;
+    // Reason why no counter could be opened
+    const std::string &error() const;
+
+    // Counts events between start and stop, consecutive regions are added up
+    void start();
+    void stop();
+    void reset();
+
+    // Counted events, scaled up when the kernel multiplexed the counter
+    double count(Event event) const;
+
+private:
+    struct Reading
+    {
+        std::uint64_t value = 0;
+        std::uint64_t enabled = 0;
+        std::uint64_t running = 0;
+    };
+
+    std::array<int, EVENTS_COUNT> fds;
+    std::array<Reading, EVENTS_COUNT> startReadings;
+    std::array<double, EVENTS_COUNT> counts;
+    std::string errorMessage;
+
+    bool read(Event event, Reading &reading) const;
+};
\ No newline at end of file
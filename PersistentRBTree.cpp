@@ -0,0 +1,453 @@
+#pragma once
+
+#include <atomic>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "PersistentRBTree.hpp"
+
+template <typename T, typename Compare>
+PersistentRBTree<T, Compare>::PersistentRBTree(const Compare &comp) :
+    version(std::make_shared<const Version>()), comp(comp)
+{
+}
+
+template <typename T, typename Compare>
+PersistentRBTree<T, Compare>::PersistentRBTree(const PersistentRBTree &other) :
+    version(other.current()), comp(other.comp)
+{
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::operator=(const PersistentRBTree &other) -> PersistentRBTree &
+{
+    if (this != &other) {
+        comp = other.comp;
+        std::atomic_store(&version, other.current());
+    }
+
+    return *this;
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::snapshot() const -> PersistentRBTree
+{
+    return *this;
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::current() const -> std::shared_ptr<const Version>
+{
+    return std::atomic_load(&version);
+}
+
+template <typename T, typename Compare>
+void PersistentRBTree<T, Compare>::publish(NodePtr root, std::size_t count)
+{
+    auto next = std::make_shared<Version>();
+    next->root = std::move(root);
+    next->count = count;
+
+    std::atomic_store(&version, std::shared_ptr<const Version>(std::move(next)));
+
+#ifndef NDEBUG
+    check();
+#endif // !NDEBUG
+}
+
+template <typename T, typename Compare>
+std::uint64_t PersistentRBTree<T, Compare>::next_stamp()
+{
+    // Stamp 0 is never handed out, nodes of finished changes can't match it
+    static std::atomic<std::uint64_t> last{ 0 };
+
+    return last.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::find_node(const NodePtr &root, const T &value) const -> const Node *
+{
+    // Binary search
+    const Node *search = root.get();
+    while (search) {
+        if (comp(value, search->value))
+            search = search->lchild.get();
+        else if (comp(search->value, value))
+            search = search->rchild.get();
+        else
+            break;
+    }
+
+    return search;
+}
+
+template <typename T, typename Compare>
+bool PersistentRBTree<T, Compare>::is_red(const NodePtr &node)
+{
+    return node && node->red;
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::make_node(const T &value) const -> FreshNodePtr
+{
+    FreshNodePtr fresh = std::make_shared<Node>(value);
+    fresh->stamp = stamp;
+
+    return fresh;
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::copy(const NodePtr &node) const -> FreshNodePtr
+{
+    FreshNodePtr fresh = std::make_shared<Node>(*node);
+    fresh->stamp = stamp;
+
+    return fresh;
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::own(const NodePtr &node) const -> FreshNodePtr
+{
+    // Nodes are built by make_shared<Node>, so changing them through a cast is allowed
+    if (node->stamp == stamp)
+        return std::const_pointer_cast<Node>(node);
+
+    return copy(node);
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::rotate_left(FreshNodePtr node) const -> FreshNodePtr
+{
+    FreshNodePtr right = own(node->rchild);
+
+    node->rchild = right->lchild;
+    right->red = node->red;
+    node->red = true;
+    right->lchild = std::move(node);
+
+    return right;
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::rotate_right(FreshNodePtr node) const -> FreshNodePtr
+{
+    FreshNodePtr left = own(node->lchild);
+
+    node->lchild = left->rchild;
+    left->red = node->red;
+    node->red = true;
+    left->rchild = std::move(node);
+
+    return left;
+}
+
+template <typename T, typename Compare>
+void PersistentRBTree<T, Compare>::flip_colors(const FreshNodePtr &node) const
+{
+    // Both children are recolored, so both are copied unless made by this change
+    FreshNodePtr left = own(node->lchild);
+    FreshNodePtr right = own(node->rchild);
+
+    node->red = !node->red;
+    left->red = !left->red;
+    right->red = !right->red;
+
+    node->lchild = std::move(left);
+    node->rchild = std::move(right);
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::move_red_left(FreshNodePtr node) const -> FreshNodePtr
+{
+    // Makes the left child or one of its children red before descending there
+    flip_colors(node);
+
+    if (is_red(node->rchild->lchild)) {
+        node->rchild = rotate_right(own(node->rchild));
+        node = rotate_left(std::move(node));
+        flip_colors(node);
+    }
+
+    return node;
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::move_red_right(FreshNodePtr node) const -> FreshNodePtr
+{
+    flip_colors(node);
+
+    if (is_red(node->lchild->lchild)) {
+        node = rotate_right(std::move(node));
+        flip_colors(node);
+    }
+
+    return node;
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::balance(FreshNodePtr node) const -> FreshNodePtr
+{
+    // Red links lean left and never follow each other
+    if (is_red(node->rchild) && !is_red(node->lchild))
+        node = rotate_left(std::move(node));
+    if (is_red(node->lchild) && is_red(node->lchild->lchild))
+        node = rotate_right(std::move(node));
+    if (is_red(node->lchild) && is_red(node->rchild))
+        flip_colors(node);
+
+    return node;
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::remove_min(FreshNodePtr node) const -> FreshNodePtr
+{
+    // Node without left child has no right child either
+    if (!node->lchild)
+        return nullptr;
+
+    if (!is_red(node->lchild) && !is_red(node->lchild->lchild))
+        node = move_red_left(std::move(node));
+
+    node->lchild = remove_min(own(node->lchild));
+
+    return balance(std::move(node));
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::insert_node(const NodePtr &node, const T &value) const -> FreshNodePtr
+{
+    if (!node)
+        return make_node(value);
+
+    FreshNodePtr fresh = copy(node);
+
+    if (comp(value, fresh->value))
+        fresh->lchild = insert_node(fresh->lchild, value);
+    else if (comp(fresh->value, value))
+        fresh->rchild = insert_node(fresh->rchild, value);
+    else {
+        fresh->count++;
+        return fresh;
+    }
+
+    return balance(std::move(fresh));
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::remove_node(FreshNodePtr node, const T &value) const -> FreshNodePtr
+{
+    if (comp(value, node->value)) {
+        if (!is_red(node->lchild) && !is_red(node->lchild->lchild))
+            node = move_red_left(std::move(node));
+
+        node->lchild = remove_node(own(node->lchild), value);
+    }
+    else {
+        if (is_red(node->lchild))
+            node = rotate_right(std::move(node));
+
+        if (!comp(node->value, value) && !node->rchild)
+            return nullptr;
+
+        if (!is_red(node->rchild) && !is_red(node->rchild->lchild))
+            node = move_red_right(std::move(node));
+
+        if (!comp(node->value, value)) {
+            // Node takes the value of its successor, which is removed instead
+            const Node *successor = node->rchild.get();
+            while (successor->lchild)
+                successor = successor->lchild.get();
+
+            node->value = successor->value;
+            node->count = successor->count;
+            node->rchild = remove_min(own(node->rchild));
+        }
+        else
+            node->rchild = remove_node(own(node->rchild), value);
+    }
+
+    return balance(std::move(node));
+}
+
+template <typename T, typename Compare>
+auto PersistentRBTree<T, Compare>::decrement_node(const NodePtr &node, const T &value) const -> FreshNodePtr
+{
+    FreshNodePtr fresh = copy(node);
+
+    if (comp(value, fresh->value))
+        fresh->lchild = decrement_node(fresh->lchild, value);
+    else if (comp(fresh->value, value))
+        fresh->rchild = decrement_node(fresh->rchild, value);
+    else
+        fresh->count--;
+
+    return fresh;
+}
+
+template <typename T, typename Compare>
+void PersistentRBTree<T, Compare>::add(const T &value)
+{
+    auto base = current();
+    stamp = next_stamp();
+
+    FreshNodePtr root = insert_node(base->root, value);
+    root->red = false;
+
+    publish(std::move(root), base->count + 1);
+}
+
+template <typename T, typename Compare>
+bool PersistentRBTree<T, Compare>::remove(const T &value)
+{
+    auto base = current();
+
+    const Node *node = find_node(base->root, value);
+    if (!node)
+        return false;
+
+    stamp = next_stamp();
+
+    if (node->count > 1) {
+        publish(decrement_node(base->root, value), base->count - 1);
+        return true;
+    }
+
+    FreshNodePtr root = copy(base->root);
+
+    // Root is made red when both children are black, so the removal can borrow from it
+    if (!is_red(root->lchild) && !is_red(root->rchild))
+        root->red = true;
+
+    root = remove_node(std::move(root), value);
+    if (root)
+        root->red = false;
+
+    publish(std::move(root), base->count - 1);
+
+    return true;
+}
+
+template <typename T, typename Compare>
+bool PersistentRBTree<T, Compare>::contains(const T &value) const
+{
+    // Version is held until the search ends, changes meanwhile don't free its nodes
+    auto base = current();
+
+    return find_node(base->root, value);
+}
+
+template <typename T, typename Compare>
+bool PersistentRBTree<T, Compare>::empty() const
+{
+    return current()->count == 0;
+}
+
+template <typename T, typename Compare>
+std::size_t PersistentRBTree<T, Compare>::size() const
+{
+    return current()->count;
+}
+
+template <typename T, typename Compare>
+template <typename F>
+void PersistentRBTree<T, Compare>::for_each(F &&visit) const
+{
+    auto base = current();
+
+    // Without parent pointers the path is kept on a stack
+    std::vector<const Node *> path;
+    const Node *node = base->root.get();
+
+    while (node || !path.empty()) {
+        while (node) {
+            path.push_back(node);
+            node = node->lchild.get();
+        }
+
+        node = path.back();
+        path.pop_back();
+
+        for (std::size_t i = 0; i < node->count; i++)
+            visit(node->value);
+        node = node->rchild.get();
+    }
+}
+
+template <typename T, typename Compare>
+void PersistentRBTree<T, Compare>::print() const
+{
+    auto base = current();
+
+    if (!base->root)
+        return;
+
+    // Print every level of the tree in a separate row
+    std::queue<const Node *> level, next_level;
+    level.push(base->root.get());
+
+    while (!level.empty()) {
+        const Node *node = level.front();
+        level.pop();
+
+        std::cout << node->value;
+        if (node->count > 1)
+            std::cout << 'x' << node->count;
+        std::cout << (node->red ? "r " : "b ");
+
+        if (node->lchild)
+            next_level.push(node->lchild.get());
+        if (node->rchild)
+            next_level.push(node->rchild.get());
+
+        if (level.empty()) {
+            std::cout << std::endl;
+            std::swap(level, next_level);
+        }
+    }
+}
+
+#ifndef NDEBUG
+template <typename T, typename Compare>
+void PersistentRBTree<T, Compare>::check() const
+{
+    auto base = current();
+
+    if (is_red(base->root))
+        throw std::runtime_error("Root is red");
+
+    check_node(base->root);
+
+    std::size_t count = 0;
+    const T *previous = nullptr;
+    for_each([&](const T &value) {
+        if (previous && previous != &value && !comp(*previous, value))
+            throw std::runtime_error("Values out of order");
+        previous = &value;
+        count++;
+    });
+
+    if (count != base->count)
+        throw std::runtime_error("Count mismatch");
+}
+
+template <typename T, typename Compare>
+std::size_t PersistentRBTree<T, Compare>::check_node(const NodePtr &node) const
+{
+    if (!node)
+        return 1;
+
+    if (is_red(node->rchild))
+        throw std::runtime_error("Right leaning red link");
+    if (node->red && is_red(node->lchild))
+        throw std::runtime_error("Two red links in a row");
+
+    std::size_t left = check_node(node->lchild);
+    if (left != check_node(node->rchild))
+        throw std::runtime_error("Black height mismatch");
+
+    return left + !node->red;
+}
+#endif // !NDEBUG
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// Red-black tree (left-leaning variant) whose versions share nodes. Nodes never change
+// once published, add and remove copy only the nodes on the path from the root and the
+// siblings they recolor, each once per change, so snapshot() is O(1). Nodes are reference
+// counted and freed when the last version using them is gone. Equal values share one
+// node with a count.
+// One thread at a time may modify a tree. snapshot() may be called from any thread
+// meanwhile and the returned version can be read without locks
+template <typename T, typename Compare = std::less<T>>
+class PersistentRBTree
+{
+public:
+    struct Node
+    {
+        T value;
+        bool red = true;
+        // Number of equal values added
+        std::size_t count = 1;
+        // Operation that made the node, it may change the node in place until it is published
+        std::uint64_t stamp = 0;
+
+        std::shared_ptr<const Node> lchild;
+        std::shared_ptr<const Node> rchild;
+
+        Node(const T &value) : value(value)
+        {
+        }
+    };
+
+private:
+    using NodePtr = std::shared_ptr<const Node>;
+    // Copies made by the running operation, not yet shared with any version
+    using FreshNodePtr = std::shared_ptr<Node>;
+
+    struct Version
+    {
+        NodePtr root;
+        std::size_t count = 0;
+    };
+
+    // Replaced as a whole on every change, accessed with atomic loads and stores
+    std::shared_ptr<const Version> version;
+    Compare comp;
+    // Stamp of the running change, unique among all trees since they may share nodes
+    std::uint64_t stamp = 0;
+
+    static std::uint64_t next_stamp();
+
+    std::shared_ptr<const Version> current() const;
+    void publish(NodePtr root, std::size_t count);
+
+    const Node *find_node(const NodePtr &root, const T &value) const;
+
+    // Helpers, nodes passed as FreshNodePtr are changed in place
+    static bool is_red(const NodePtr &node);
+    FreshNodePtr make_node(const T &value) const;
+    FreshNodePtr copy(const NodePtr &node) const;
+    // Node itself when the running change made it already, its copy otherwise
+    FreshNodePtr own(const NodePtr &node) const;
+    FreshNodePtr rotate_left(FreshNodePtr node) const;
+    FreshNodePtr rotate_right(FreshNodePtr node) const;
+    void flip_colors(const FreshNodePtr &node) const;
+    FreshNodePtr move_red_left(FreshNodePtr node) const;
+    FreshNodePtr move_red_right(FreshNodePtr node) const;
+    FreshNodePtr balance(FreshNodePtr node) const;
+    FreshNodePtr remove_min(FreshNodePtr node) const;
+
+    FreshNodePtr insert_node(const NodePtr &node, const T &value) const;
+    // Value must be present in the subtree
+    FreshNodePtr remove_node(FreshNodePtr node, const T &value) const;
+    // Copies the path to the node of the value and lowers its count, shape is kept
+    FreshNodePtr decrement_node(const NodePtr &node, const T &value) const;
+
+    // Assertions
+#ifndef NDEBUG
+    void check() const;
+    // Returns number of black nodes on every path down from the node
+    std::size_t check_node(const NodePtr &node) const;
+#endif // !NDEBUG
+
+public:
+    PersistentRBTree(const Compare &comp = Compare());
+
+    // Copies share the version of the other tree, O(1)
+    PersistentRBTree(const PersistentRBTree &other);
+    PersistentRBTree &operator=(const PersistentRBTree &other);
+
+    // Current version, later changes of this tree don't affect it
+    PersistentRBTree snapshot() const;
+
+    void add(const T &value);
+    bool remove(const T &value);
+    bool contains(const T &value) const;
+
+    bool empty() const;
+    std::size_t size() const;
+
+    // Visits values of the current version in order
+    template <typename F>
+    void for_each(F &&visit) const;
+
+    void print() const;
+};
+
+// For template explicit instantiations
+#include "PersistentRBTree.cpp"
\ No newline at end of file
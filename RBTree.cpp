@@ -1,15 +1,23 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "RBTree.hpp"
+#include "OutputBuffer.hpp"
+#include "Snapshot.hpp"
 
 #define RST  "\x1B[0m"
 #define KRED  "\x1B[41m"
 
-template <typename T>
-void RBTree<T>::delete_children(Node *parent)
+template <typename T, typename Compare>
+void RBTree<T, Compare>::delete_children(Node *parent)
 {
     // Recursively delete all children of a parent
     if (parent->lchild)
@@ -24,52 +32,252 @@ void RBTree<T>::delete_children(Node *parent)
 #endif // NDEBUG
 }
 
-template <typename T>
-RBTree<T>::~RBTree()
+template <typename T, typename Compare>
+RBTree<T, Compare>::RBTree(const Compare &comp) : comp(comp)
+{
+}
+
+template <typename T, typename Compare>
+RBTree<T, Compare>::~RBTree()
 {
     if (root)
         delete_children(root);
 }
 
-template <typename T>
-void RBTree<T>::add(const T &value)
+template <typename T, typename Compare>
+auto RBTree<T, Compare>::add(const T &value) -> Node *
 {
-    if (!root) {
-        Node *node = new Node;
-        node->value = value;
+    // Binary search
+    Node **search = &root;
+    Node *parent = nullptr;
 
-        // Root is always black
-        node->color = Color::BLACK;
-        root = node;
+    while (*search) {
+        parent = *search;
 
-#ifndef NDEBUG
-        counter++;
-#endif // !NDEBUG
+        if (comp(value, parent->value))
+            search = &parent->lchild;
+        else
+            search = &parent->rchild;
+    }
 
-        return;
+    Node *node = new Node(value);
+    link_node(node, parent, search);
+
+    return node;
+}
+
+template <typename T, typename Compare>
+auto RBTree<T, Compare>::insert_hint(Node *hint, const T &value) -> Node *
+{
+    if (!hint || comp(value, hint->value))
+        return add(value);
+
+    Node **slot;
+
+    if (hint->rchild) {
+        // New node becomes lchild of the hint's successor
+        hint = hint->rchild;
+        while (hint->lchild)
+            hint = hint->lchild;
+
+        if (comp(hint->value, value))
+            return add(value);
+
+        slot = &hint->lchild;
+    }
+    else {
+        // Successor is the first ancestor having hint in its left subtree
+        if (hint != rightmost) {
+            Node *successor = hint;
+            while (successor->parent->rchild == successor)
+                successor = successor->parent;
+            successor = successor->parent;
+
+            if (comp(successor->value, value))
+                return add(value);
+        }
+
+        slot = &hint->rchild;
     }
 
+    Node *node = new Node(value);
+    link_node(node, hint, slot);
+
+    return node;
+}
+
+template <typename T, typename Compare>
+auto RBTree<T, Compare>::find(const T &value) const -> Node *
+{
+    return find_node(value);
+}
+
+template <typename T, typename Compare>
+void RBTree<T, Compare>::erase(Node *node)
+{
+    if (!node)
+        throw std::runtime_error("Node is empty!");
+
+    remove_node(node);
+}
+
+template <typename T, typename Compare>
+template <typename K, typename F>
+void RBTree<T, Compare>::find_many(const K *values, std::size_t count, F &&found) const
+{
+    const std::size_t group = 16;
+    Node *nodes[group];
+
+    for (std::size_t first = 0; first < count; first += group) {
+        std::size_t size = std::min(group, count - first);
+        std::size_t active = size;
+
+        for (std::size_t i = 0; i < size; i++)
+            nodes[i] = root;
+
+        if (!root) {
+            for (std::size_t i = 0; i < size; i++)
+                found(first + i, nullptr);
+            continue;
+        }
+
+        // Finished walks are marked with nullptr
+        while (active) {
+            for (std::size_t i = 0; i < size; i++) {
+                Node *node = nodes[i];
+                if (!node)
+                    continue;
+
+                const K &value = values[first + i];
+                Node *next;
+
+                if (comp(value, node->value))
+                    next = node->lchild;
+                else if (comp(node->value, value))
+                    next = node->rchild;
+                else {
+                    found(first + i, node);
+                    nodes[i] = nullptr;
+                    active--;
+                    continue;
+                }
+
+                if (!next) {
+                    found(first + i, nullptr);
+                    active--;
+                }
+                else
+                    __builtin_prefetch(next);
+
+                nodes[i] = next;
+            }
+        }
+    }
+}
+
+template <typename T, typename Compare>
+void RBTree<T, Compare>::add_many(const T *values, std::size_t count)
+{
+    const std::size_t group = 16;
+
+    for (std::size_t first = 0; first < count; first += group) {
+        std::size_t size = std::min(group, count - first);
+
+        // Walk only brings the paths into cache, adding changes the tree
+        find_many(values + first, size, [](std::size_t, Node *) {});
+
+        for (std::size_t i = first; i < first + size; i++)
+            add(values[i]);
+    }
+}
+
+template <typename T, typename Compare>
+std::size_t RBTree<T, Compare>::remove_many(const T *values, std::size_t count)
+{
+    const std::size_t group = 16;
+    std::size_t removed = 0;
+
+    for (std::size_t first = 0; first < count; first += group) {
+        std::size_t size = std::min(group, count - first);
+
+        find_many(values + first, size, [](std::size_t, Node *) {});
+
+        for (std::size_t i = first; i < first + size; i++)
+            removed += remove(values[i]);
+    }
+
+    return removed;
+}
+
+template <typename T, typename Compare>
+std::size_t RBTree<T, Compare>::contains_many(const T *values, std::size_t count, bool *results) const
+{
+    std::size_t present = 0;
+
+    find_many(values, count, [&](std::size_t i, Node *node) {
+        results[i] = node;
+        present += node != nullptr;
+    });
+
+    return present;
+}
+
+template <typename T, typename Compare>
+template <typename K>
+auto RBTree<T, Compare>::find_node(const K &key) const -> Node *
+{
     // Binary search
+    Node *search = root;
+    while (search) {
+        if (comp(key, search->value))
+            search = search->lchild;
+        else if (comp(search->value, key))
+            search = search->rchild;
+        else
+            break;
+    }
+
+    return search;
+}
+
+template <typename T, typename Compare>
+template <typename K>
+auto RBTree<T, Compare>::find_slot(const K &key, Node *&parent) -> Node **
+{
     Node **search = &root;
-    Node *parent;
+    parent = nullptr;
 
     while (*search) {
-        parent = *search;
-
-        if (parent->value > value)
+        if (comp(key, (*search)->value)) {
+            parent = *search;
             search = &parent->lchild;
-        else
+        }
+        else if (comp((*search)->value, key)) {
+            parent = *search;
             search = &parent->rchild;
+        }
+        else
+            break;
     }
 
-    // Create new node and add it to the tree
-    Node *node = new Node;
-    node->value = value;
+    return search;
+}
+
+template <typename T, typename Compare>
+void RBTree<T, Compare>::link_node(Node *node, Node *parent, Node **slot)
+{
+    // Add new node to the tree
     node->parent = parent;
+    *slot = node;
 
-    *search = node;
+    if (!parent || (parent == rightmost && slot == &parent->rchild))
+        rightmost = node;
 
-    rebalance(node);
+    if (node == root)
+        // Root is always black
+        node->color = Color::BLACK;
+    else
+        rebalance(node);
 
 #ifndef NDEBUG
     counter++;
@@ -78,22 +286,22 @@ void RBTree<T>::add(const T &value)
 #endif // !NDEBUG
 }
 
-template <typename T>
-inline auto RBTree<T>::getParentToChildPointer(const RBTree<T>::Node *child) -> RBTree<T>::Node *&
+template <typename T, typename Compare>
+inline auto RBTree<T, Compare>::getParentToChildPointer(const RBTree<T, Compare>::Node *child) -> RBTree<T, Compare>::Node *&
 {
     return (child == root ? root :
             (child->parent->lchild == child ? child->parent->lchild : child->parent->rchild));
 }
 
-template <typename T>
-inline auto RBTree<T>::getParentToSiblingPointer(const RBTree<T>::Node *child) -> RBTree<T>::Node *&
+template <typename T, typename Compare>
+inline auto RBTree<T, Compare>::getParentToSiblingPointer(const RBTree<T, Compare>::Node *child) -> RBTree<T, Compare>::Node *&
 {
     return (child->parent->lchild == child ? child->parent->rchild : child->parent->lchild);
 }
 
-template <typename T>
-template <typename RBTree<T>::RotationDirection R>
-void RBTree<T>::__rotate_template(RBTree<T>::Node *node)
+template <typename T, typename Compare>
+template <typename RBTree<T, Compare>::RotationDirection R>
+void RBTree<T, Compare>::__rotate_template(RBTree<T, Compare>::Node *node)
 {
     Node *parent = node->parent;
 
@@ -123,20 +331,55 @@ void RBTree<T>::__rotate_template(RBTree<T>::Node *node)
         child_swap->parent = parent;
 }
 
-template <typename T>
-void RBTree<T>::rotate_left(Node *node)
+template <typename T, typename Compare>
+void RBTree<T, Compare>::swap_with_predecessor(Node *node, Node *predecessor)
+{
+    // Predecessor is the largest node of the left subtree, so it has no rchild
+    Node *predecessor_parent = predecessor->parent;
+    Node *predecessor_lchild = predecessor->lchild;
+
+    // Predecessor takes the place of the node
+    getParentToChildPointer(node) = predecessor;
+    predecessor->parent = node->parent;
+
+    predecessor->rchild = node->rchild;
+    predecessor->rchild->parent = predecessor;
+
+    if (predecessor_parent == node) {
+        predecessor->lchild = node;
+        node->parent = predecessor;
+    }
+    else {
+        predecessor->lchild = node->lchild;
+        predecessor->lchild->parent = predecessor;
+
+        predecessor_parent->rchild = node;
+        node->parent = predecessor_parent;
+    }
+
+    // Node takes the place of the predecessor
+    node->lchild = predecessor_lchild;
+    if (predecessor_lchild)
+        predecessor_lchild->parent = node;
+    node->rchild = nullptr;
+
+    std::swap(node->color, predecessor->color);
+}
+
+template <typename T, typename Compare>
+void RBTree<T, Compare>::rotate_left(Node *node)
 {
     __rotate_template<RotationDirection::LEFT>(node);
 }
 
-template <typename T>
-void RBTree<T>::rotate_right(Node *node)
+template <typename T, typename Compare>
+void RBTree<T, Compare>::rotate_right(Node *node)
 {
     __rotate_template<RotationDirection::RIGHT>(node);
 }
 
-template <typename T>
-void RBTree<T>::rebalance(Node *node)
+template <typename T, typename Compare>
+void RBTree<T, Compare>::rebalance(Node *node)
 {
     while (node != root && node->parent->color == Color::RED) {
         Node *parent = node->parent;
@@ -148,7 +391,7 @@ void RBTree<T>::rebalance(Node *node)
 
             // Swap node with parent if node's value is between parent and grandparent
             // This is a special case preliminary to actual tree rotation
-            if (parent->value < node->value && grandparent->value > node->value) {
+            if (parent->rchild == node && grandparent->lchild == parent) {
                 // Parent is lchild
                 rotate_left(node);
 
@@ -156,7 +399,7 @@ void RBTree<T>::rebalance(Node *node)
                 parent = node->parent;
                 grandparent = parent->parent;
             }
-            else if (parent->value > node->value && grandparent->value < node->value) {
+            else if (parent->lchild == node && grandparent->rchild == parent) {
                 // Parent is rchild
                 rotate_right(node);
 
@@ -197,21 +440,33 @@ void RBTree<T>::rebalance(Node *node)
 #endif // !NDEBUG
 }
 
-template <typename T>
-bool RBTree<T>::remove(const T &value)
+template <typename T, typename Compare>
+bool RBTree<T, Compare>::remove(const T &value)
 {
-    // Binary search
-    Node *nodeToBeRemoved = root;
-    while (nodeToBeRemoved && nodeToBeRemoved->value != value) {
-        if (nodeToBeRemoved->value > value)
-            nodeToBeRemoved = nodeToBeRemoved->lchild;
-        else
-            nodeToBeRemoved = nodeToBeRemoved->rchild;
-    }
+    Node *node = find_node(value);
 
-    if (!nodeToBeRemoved)
+    if (!node)
         return false;
 
+    remove_node(node);
+
+    return true;
+}
+
+template <typename T, typename Compare>
+void RBTree<T, Compare>::remove_node(Node *nodeToBeRemoved)
+{
+    // Largest node has no rchild, its predecessor is the largest lchild or the parent
+    if (nodeToBeRemoved == rightmost) {
+        if (nodeToBeRemoved->lchild) {
+            rightmost = nodeToBeRemoved->lchild;
+            while (rightmost->rchild)
+                rightmost = rightmost->rchild;
+        }
+        else
+            rightmost = nodeToBeRemoved->parent;
+    }
+
     int children_count;
     Node *dbFix;
     bool nodeIsRed = false;
@@ -224,15 +479,15 @@ bool RBTree<T>::remove(const T &value)
     children_count = (nodeToBeRemoved->lchild ? 1 : 0) +
         (nodeToBeRemoved->rchild ? 1 : 0);
 
-    // If a node has two children then replace it with its largest lchild
+    // If a node has two children then swap it with its largest lchild,
+    // nodes are relinked so values are never copied or moved
     if (children_count == 2) {
         Node *largest_lchild = nodeToBeRemoved->lchild;
 
         while (largest_lchild->rchild)
             largest_lchild = largest_lchild->rchild;
 
-        nodeToBeRemoved->value = largest_lchild->value;
-        nodeToBeRemoved = largest_lchild;
+        swap_with_predecessor(nodeToBeRemoved, largest_lchild);
 
         children_count = (nodeToBeRemoved->lchild ? 1 : 0) +
             (nodeToBeRemoved->rchild ? 1 : 0);
@@ -363,107 +618,235 @@ out:
         check_depth(root);
     }
 #endif // !NDEBUG
-
-    return true;
 }
 
-template <typename T>
-bool RBTree<T>::contains(const T &value) const
+template <typename T, typename Compare>
+bool RBTree<T, Compare>::contains(const T &value) const
 {
-    const Node *search = root;
-    while (search && search->value != value) {
-        if (search->value > value)
-            search = search->lchild;
-        else
-            search = search->rchild;
-    }
-
-    if (search)
-        return true;
+    return find_node(value);
+}
 
-    return false;
+template <typename T, typename Compare>
+void RBTree<T, Compare>::print() const
+{
+    OutputBuffer output;
+    dump(output);
 }
 
-template <typename T>
-void RBTree<T>::print() const
+template <typename T, typename Compare>
+void RBTree<T, Compare>::dump(OutputBuffer &output, bool plain) const
 {
     if (!root)
         return;
 
-    std::queue<Node *> kolejka, kolejka2;
+    // Level is stored as its nodes with the number of empty places before each of them,
+    // empty places are printed as N without walking their empty subtrees
+    struct Entry
+    {
+        const Node *node;
+        std::size_t empty_before;
+    };
+
+    std::vector<Entry> level = { { root, 0 } }, next;
+    std::size_t width = 1, padding = 0;
+
+    while (!level.empty()) {
+        std::size_t position = 0, empty = 0;
+        next.clear();
+
+        for (const auto &entry : level) {
+            for (std::size_t i = 0; i < entry.empty_before; i++)
+                output.write("N ", 2);
+            position += entry.empty_before + 1;
+
+            const Node *node = entry.node;
+            const char *color = !plain && node->color == Color::RED ? KRED : nullptr;
+
+            if (color)
+                output.write(color, std::strlen(color));
+            output.writeValue(node->value);
+            if (color)
+                output.write(RST, std::strlen(RST));
+            output.put(' ');
+
+            empty += 2 * entry.empty_before;
+            if (node->lchild) {
+                next.push_back({ node->lchild, empty });
+                empty = 0;
+            }
+            else
+                empty++;
 
-    Node *empty = new Node();
+            if (node->rchild) {
+                next.push_back({ node->rchild, empty });
+                empty = 0;
+            }
+            else
+                empty++;
+        }
 
-    int pow = 1, cur_pow = 0;
+        padding = width - position;
+        for (std::size_t i = 0; i < padding; i++)
+            output.write("N ", 2);
+        output.put('\n');
 
-    kolejka.push(root);
-    kolejka2.push(root);
+        width *= 2;
+        level.swap(next);
+    }
 
-    while (!kolejka2.empty()) {
-        if (kolejka.front() == empty)
-            std::cout << "N";
-        else if (kolejka.front()->color == Color::RED)
-            std::cout << KRED << kolejka.front()->value << RST;
-        else
-            std::cout << kolejka.front()->value;
+    // Empty line follows only a tree that fills its last level up to the last node
+    if (padding == 0)
+        output.put('\n');
+}
 
-        std::cout << " ";
+template <typename T, typename Compare>
+void RBTree<T, Compare>::save(const std::string &path) const
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot stores raw values");
 
-        if (++cur_pow == pow) {
-            std::cout << std::endl;
-            cur_pow = 0;
-            pow *= 2;
-        }
+    std::vector<T> values;
+    std::vector<std::uint8_t> shapes;
+    std::vector<Node *> stack;
 
-        if (kolejka.front()->lchild) {
-            kolejka.push(kolejka.front()->lchild);
-            kolejka2.push(kolejka.front()->lchild);
-        }
-        else
-            kolejka.push(empty);
+    if (root)
+        stack.push_back(root);
+
+    // Pre-order, right child is pushed first so the left subtree is visited next
+    while (!stack.empty()) {
+        Node *node = stack.back();
+        stack.pop_back();
+
+        values.push_back(node->value);
+        shapes.push_back((node->lchild ? SHAPE_LEFT : 0) | (node->rchild ? SHAPE_RIGHT : 0) |
+                         (node->color == Color::BLACK ? SHAPE_BLACK : 0));
+
+        if (node->rchild)
+            stack.push_back(node->rchild);
+        if (node->lchild)
+            stack.push_back(node->lchild);
+    }
+
+    SnapshotWriter writer(path, SnapshotKind::RBTREE, sizeof(T), values.size());
+    writer.write(values.data(), values.size() * sizeof(T));
+    writer.write(shapes.data(), shapes.size());
+    writer.finish();
+}
+
+template <typename T, typename Compare>
+bool RBTree<T, Compare>::valid_snapshot(const char *values, const std::uint8_t *shapes, std::size_t count) const
+{
+    if (count && !(shapes[0] & SHAPE_BLACK))
+        return false;
+
+    std::vector<std::uint64_t> left, right;
+    SnapshotReader::treeChildren(shapes, count, left, right);
+
+    // Black nodes on every path down, empty links count as one black node
+    std::vector<std::size_t> blackHeights(count);
+    for (std::size_t i = count; i > 0; i--) {
+        bool red = !(shapes[i - 1] & SHAPE_BLACK);
+        std::size_t lheight = 1, rheight = 1;
 
-        if (kolejka.front()->rchild) {
-            kolejka.push(kolejka.front()->rchild);
-            kolejka2.push(kolejka.front()->rchild);
+        if (left[i - 1] != count) {
+            if (red && !(shapes[left[i - 1]] & SHAPE_BLACK))
+                return false;
+            lheight = blackHeights[left[i - 1]];
+        }
+        if (right[i - 1] != count) {
+            if (red && !(shapes[right[i - 1]] & SHAPE_BLACK))
+                return false;
+            rheight = blackHeights[right[i - 1]];
         }
-        else
-            kolejka.push(empty);
 
-        if (kolejka.front() != empty)
-            kolejka2.pop();
+        if (lheight != rheight)
+            return false;
 
-        kolejka.pop();
+        blackHeights[i - 1] = lheight + !red;
     }
 
-    if (cur_pow != 0)
-        while (cur_pow++ < pow)
-            std::cout << "N ";
+    return SnapshotReader::orderedTree<T>(values, left, right, comp);
+}
+
+template <typename T, typename Compare>
+void RBTree<T, Compare>::load(const std::string &path)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot stores raw values");
+
+    SnapshotReader reader(path, SnapshotKind::RBTREE, sizeof(T));
+    std::size_t count = reader.count();
+    const char *values = (const char *)reader.read(count, sizeof(T));
+    const std::uint8_t *shapes = (const std::uint8_t *)reader.read(count, 1);
+    reader.finish();
+
+    if (!SnapshotReader::validTreeShape(shapes, count))
+        throw std::runtime_error("Snapshot has invalid tree shape!");
+    if (!valid_snapshot(values, shapes, count))
+        throw std::runtime_error("Snapshot is not a valid red-black tree!");
+
+    if (root)
+        delete_children(root);
+    root = nullptr;
+    rightmost = nullptr;
+
+    // Empty links waiting for the next node in pre-order, with their parent
+    std::vector<std::pair<Node *, Node **>> slots = { { nullptr, &root } };
+
+    // Shape is rebuilt exactly as saved, without comparisons or rebalancing
+    for (std::size_t i = 0; i < count; i++) {
+        auto [parent, slot] = slots.back();
+        slots.pop_back();
+
+        T value;
+        std::memcpy(&value, values + i * sizeof(T), sizeof(T));
+
+        Node *node = new Node(value);
+        node->color = shapes[i] & SHAPE_BLACK ? Color::BLACK : Color::RED;
+        node->parent = parent;
+        *slot = node;
+#ifndef NDEBUG
+        counter++;
+#endif // !NDEBUG
+
+        if (shapes[i] & SHAPE_RIGHT)
+            slots.push_back({ node, &node->rchild });
+        if (shapes[i] & SHAPE_LEFT)
+            slots.push_back({ node, &node->lchild });
+    }
 
-    std::cout << std::endl;
+    rightmost = root;
+    while (rightmost && rightmost->rchild)
+        rightmost = rightmost->rchild;
 
-    delete empty;
+#ifndef NDEBUG
+    if (root) {
+        check_children(root);
+        check_parent(root);
+        check_coloring(root);
+        check_depth(root);
+    }
+#endif // !NDEBUG
 }
 
 #ifndef NDEBUG
-template <typename T>
-void RBTree<T>::check_children(Node *parent)
+template <typename T, typename Compare>
+void RBTree<T, Compare>::check_children(Node *parent)
 {
-    T val = parent->value;
+    const T &val = parent->value;
 
     if (parent->lchild) {
-        if (val < parent->lchild->value)
+        if (comp(val, parent->lchild->value))
             throw std::runtime_error("nope");
         check_children(parent->lchild);
     }
     if (parent->rchild) {
-        if (val > parent->rchild->value)
+        if (comp(parent->rchild->value, val))
             throw std::runtime_error("nope");
         check_children(parent->rchild);
     }
 }
 
-template <typename T>
-void RBTree<T>::check_parent(Node *parent)
+template <typename T, typename Compare>
+void RBTree<T, Compare>::check_parent(Node *parent)
 {
     if (parent == root)
         if (root->parent)
@@ -481,8 +864,8 @@ void RBTree<T>::check_parent(Node *parent)
     }
 }
 
-template <typename T>
-void RBTree<T>::check_coloring(Node *parent)
+template <typename T, typename Compare>
+void RBTree<T, Compare>::check_coloring(Node *parent)
 {
     if (parent == root)
         if (root->color != Color::BLACK)
@@ -506,8 +889,8 @@ void RBTree<T>::check_coloring(Node *parent)
     }
 }
 
-template <typename T>
-void RBTree<T>::check_depth(Node *parent)
+template <typename T, typename Compare>
+void RBTree<T, Compare>::check_depth(Node *parent)
 {
     if (!root)
         return;
@@ -524,8 +907,8 @@ void RBTree<T>::check_depth(Node *parent)
     __check_depth(root, depth, 0);
 }
 
-template <typename T>
-void RBTree<T>::__check_depth(Node *parent, const int &depth, int current_depth)
+template <typename T, typename Compare>
+void RBTree<T, Compare>::__check_depth(Node *parent, const int &depth, int current_depth)
 {
     if (parent->color == Color::BLACK)
         current_depth++;
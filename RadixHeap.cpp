@@ -0,0 +1,222 @@
+#pragma once
+
+#include <iostream>
+#include <stdexcept>
+
+#include "RadixHeap.hpp"
+
+template <typename T>
+RadixHeap<T>::~RadixHeap()
+{
+    for (auto node : buckets) {
+        while (node) {
+            Node *next = node->next;
+
+            delete node;
+            node = next;
+        }
+    }
+}
+
+template <typename T>
+inline auto RadixHeap<T>::to_key(const T &value) -> Key
+{
+    // Flip the sign bit so signed values keep their order as unsigned keys
+    if constexpr (std::is_signed_v<T>)
+        return (Key)value ^ ((Key)1 << (sizeof(Key) * 8 - 1));
+    else
+        return value;
+}
+
+template <typename T>
+inline std::size_t RadixHeap<T>::bucket_of(const Key &key) const
+{
+    if (key == last)
+        return 0;
+
+    return 64 - __builtin_clzll((unsigned long long)(key ^ last));
+}
+
+template <typename T>
+void RadixHeap<T>::link(Node *node)
+{
+    std::size_t bucket = bucket_of(to_key(node->value));
+
+    node->bucket = bucket;
+    node->prev = nullptr;
+    node->next = buckets[bucket];
+
+    if (node->next)
+        node->next->prev = node;
+
+    buckets[bucket] = node;
+}
+
+template <typename T>
+void RadixHeap<T>::unlink(Node *node)
+{
+    if (node->prev)
+        node->prev->next = node->next;
+    else
+        // node is the head of its bucket
+        buckets[node->bucket] = node->next;
+
+    if (node->next)
+        node->next->prev = node->prev;
+}
+
+template <typename T>
+void RadixHeap<T>::refill()
+{
+    if (buckets[0])
+        return;
+
+    std::size_t bucket = 1;
+    while (!buckets[bucket])
+        bucket++;
+
+    // Smallest value of the first non-empty bucket becomes the new reference,
+    // all values in this bucket move to lower buckets
+    Node *node = buckets[bucket];
+    last = to_key(node->value);
+
+    for (; node; node = node->next) {
+        if (to_key(node->value) < last)
+            last = to_key(node->value);
+    }
+
+    node = buckets[bucket];
+    buckets[bucket] = nullptr;
+
+    while (node) {
+        Node *next = node->next;
+
+        link(node);
+        node = next;
+    }
+}
+
+template <typename T>
+auto RadixHeap<T>::add(const T &value) -> Node *
+{
+    if (to_key(value) < last)
+        throw std::runtime_error("Value is smaller than the last removed one");
+
+    Node *node = new Node();
+    node->value = value;
+
+    link(node);
+    count++;
+
+    return node;
+}
+
+template <typename T>
+const T &RadixHeap<T>::top()
+{
+    if (count == 0)
+        throw std::out_of_range("Heap is empty");
+
+    refill();
+
+    return buckets[0]->value;
+}
+
+template <typename T>
+void RadixHeap<T>::pop()
+{
+    if (count == 0)
+        return;
+
+    refill();
+
+    Node *node = buckets[0];
+    unlink(node);
+    count--;
+
+    delete node;
+}
+
+template <typename T>
+void RadixHeap<T>::decrease_key(Node *node, const T &value)
+{
+    if (!node)
+        throw std::runtime_error("Node is empty!");
+    if (node->value < value)
+        throw std::runtime_error("New key is larger than the current one");
+    if (to_key(value) < last)
+        throw std::runtime_error("Value is smaller than the last removed one");
+
+    unlink(node);
+    node->value = value;
+    link(node);
+}
+
+template <typename T>
+bool RadixHeap<T>::remove(Node *node)
+{
+    if (!node)
+        return false;
+
+    unlink(node);
+    count--;
+
+    delete node;
+
+    return true;
+}
+
+template <typename T>
+bool RadixHeap<T>::remove(const T &value)
+{
+    return remove(find(value));
+}
+
+template <typename T>
+auto RadixHeap<T>::find(const T &value) const -> Node *
+{
+    if (to_key(value) < last)
+        return nullptr;
+
+    // All equal values end up in the same bucket
+    for (Node *node = buckets[bucket_of(to_key(value))]; node; node = node->next) {
+        if (node->value == value)
+            return node;
+    }
+
+    return nullptr;
+}
+
+template <typename T>
+bool RadixHeap<T>::contains(const T &value) const
+{
+    return find(value);
+}
+
+template <typename T>
+bool RadixHeap<T>::empty() const
+{
+    return count == 0;
+}
+
+template <typename T>
+const std::size_t &RadixHeap<T>::size() const
+{
+    return count;
+}
+
+template <typename T>
+void RadixHeap<T>::print() const
+{
+    for (std::size_t bucket = 0; bucket < BUCKETS_COUNT; bucket++) {
+        if (!buckets[bucket])
+            continue;
+
+        std::cout << bucket << ": ";
+
+        for (Node *node = buckets[bucket]; node; node = node->next)
+            std::cout << node->value << " ";
+
+        std::cout << std::endl;
+    }
+}
\ No newline at end of file
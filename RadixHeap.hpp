@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+// Min-heap for monotone integer priorities: a value can be added only
+// if it is not smaller than the last value removed from the top
+template <typename T>
+class RadixHeap
+{
+    static_assert(std::is_integral_v<T>, "RadixHeap requires integer values");
+
+    typedef std::make_unsigned_t<T> Key;
+
+public:
+    struct Node
+    {
+        T value;
+        std::size_t bucket = 0;
+
+        Node *prev = nullptr;
+        Node *next = nullptr;
+    };
+
+    RadixHeap() = default;
+    ~RadixHeap();
+
+    // Returned handle stays valid until the node is removed
+    Node *add(const T &value);
+
+    // Smallest element of the heap
+    const T &top();
+    // Remove the smallest element, does nothing if heap is empty
+    void pop();
+
+    // New value must not be larger than the current one
+    void decrease_key(Node *node, const T &value);
+
+    bool remove(const T &value);
+    bool remove(Node *node);
+    bool contains(const T &value) const;
+
+    bool empty() const;
+    const std::size_t &size() const;
+    void print() const;
+
+private:
+    // Bucket 0 holds values equal to the last removed one, bucket i
+    // holds values whose highest bit differing from it is bit i-1
+    static constexpr std::size_t BUCKETS_COUNT = sizeof(Key) * 8 + 1;
+
+    Node *buckets[BUCKETS_COUNT] = {};
+    Key last = 0;
+    std::size_t count = 0;
+
+    Node *find(const T &value) const;
+
+    // Helpers
+    static Key to_key(const T &value);
+    std::size_t bucket_of(const Key &key) const;
+    void link(Node *node);
+    void unlink(Node *node);
+    void refill();
+};
+
+// For template explicit instantiations
+#include "RadixHeap.cpp"
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "Snapshot.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+static const char SNAPSHOT_MAGIC[4] = { 'S', 'D', 'Z', 'S' };
+
+struct SnapshotHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t kind;
+    std::uint32_t elementSize;
+    std::uint64_t count;
+};
+
+static_assert(sizeof(SnapshotHeader) == 24, "Snapshot header must not contain padding");
+
+SnapshotWriter::SnapshotWriter(const std::string &path, SnapshotKind kind, std::size_t elementSize,
+                               std::uint64_t count) :
+    file(path, std::ios::binary | std::ios::trunc), path(path)
+{
+    if (!file.is_open())
+        throw std::runtime_error("Cannot create snapshot " + path + "!");
+
+    SnapshotHeader header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.kind = (std::uint32_t)kind;
+    header.elementSize = elementSize;
+    header.count = count;
+
+    write(&header, sizeof(header));
+}
+
+void SnapshotWriter::write(const void *data, std::size_t bytes)
+{
+    file.write((const char *)data, bytes);
+}
+
+void SnapshotWriter::finish()
+{
+    file.flush();
+    if (!file)
+        throw std::runtime_error("Cannot write snapshot " + path + "!");
+}
+
+SnapshotReader::SnapshotReader(const std::string &path, SnapshotKind kind, std::size_t elementSize) : file(path)
+{
+    SnapshotHeader header;
+
+    if (file.size() < sizeof(header))
+        throw std::runtime_error("File " + path + " is not a snapshot!");
+
+    std::memcpy(&header, file.data(), sizeof(header));
+    position = sizeof(header);
+
+    // File written on a machine of different byte order fails the version check
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        header.version != SNAPSHOT_VERSION)
+        throw std::runtime_error("File " + path + " is not a snapshot of this version!");
+    if (header.kind != (std::uint32_t)kind)
+        throw std::runtime_error("Snapshot " + path + " holds a different container!");
+    if (header.elementSize != elementSize)
+        throw std::runtime_error("Snapshot " + path + " holds values of a different type!");
+
+    elementsCount = header.count;
+}
+
+std::uint64_t SnapshotReader::count() const
+{
+    return elementsCount;
+}
+
+const void *SnapshotReader::read(std::uint64_t count, std::size_t elementSize)
+{
+    if (count > (file.size() - position) / elementSize)
+        throw std::runtime_error("Snapshot is truncated!");
+
+    const char *data = file.data() + position;
+    position += count * elementSize;
+
+    return data;
+}
+
+void SnapshotReader::finish() const
+{
+    if (position != file.size())
+        throw std::runtime_error("Snapshot has unexpected data at its end!");
+}
+
+bool SnapshotReader::validTreeShape(const std::uint8_t *shapes, std::uint64_t count)
+{
+    // Subtrees announced by already read nodes but not started yet
+    std::uint64_t pending = count ? 1 : 0;
+
+    for (std::uint64_t i = 0; i < count; i++) {
+        if (pending == 0)
+            return false;
+
+        pending--;
+        pending += (shapes[i] & SHAPE_LEFT ? 1 : 0) + (shapes[i] & SHAPE_RIGHT ? 1 : 0);
+    }
+
+    return pending == 0;
+}
+
+void SnapshotReader::treeChildren(const std::uint8_t *shapes, std::uint64_t count,
+                                  std::vector<std::uint64_t> &left, std::vector<std::uint64_t> &right)
+{
+    left.assign(count, count);
+    right.assign(count, count);
+
+    // Links waiting for the next node in pre-order, parent is count for the root
+    std::vector<std::pair<std::uint64_t, bool>> slots = { { count, true } };
+
+    for (std::uint64_t i = 0; i < count; i++) {
+        auto [parent, isLeft] = slots.back();
+        slots.pop_back();
+
+        if (parent != count)
+            (isLeft ? left : right)[parent] = i;
+
+        if (shapes[i] & SHAPE_RIGHT)
+            slots.push_back({ i, false });
+        if (shapes[i] & SHAPE_LEFT)
+            slots.push_back({ i, true });
+    }
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "MappedFile.hpp"
+
+// Binary container snapshot: a 24 byte header followed by the raw values in native byte order.
+// Trees store values in pre-order followed by one SnapshotShape byte per node.
+
+enum class SnapshotKind : std::uint32_t
+{
+    ARRAY = 1,
+    LIST,
+    BINHEAP,
+    RBTREE,
+    AVLTREE
+};
+
+enum SnapshotShape : std::uint8_t
+{
+    // Node has a left or right child, children follow it in pre-order
+    SHAPE_LEFT = 1,
+    SHAPE_RIGHT = 2,
+    // RBTree node is black
+    SHAPE_BLACK = 4
+};
+
+const std::uint32_t SNAPSHOT_VERSION = 1;
+
+class SnapshotWriter
+{
+    std::ofstream file;
+    std::string path;
+
+public:
+    // Throws std::runtime_error when the file cannot be created
+    SnapshotWriter(const std::string &path, SnapshotKind kind, std::size_t elementSize, std::uint64_t count);
+
+    void write(const void *data, std::size_t bytes);
+    // Flushes the file and reports write errors
+    void finish();
+};
+
+class SnapshotReader
+{
+    MappedFile file;
+    std::size_t position = 0;
+    std::uint64_t elementsCount = 0;
+
+public:
+    // Throws std::runtime_error when the file is not a snapshot of this kind and element size
+    SnapshotReader(const std::string &path, SnapshotKind kind, std::size_t elementSize);
+
+    std::uint64_t count() const;
+
+    // Next count elements of the mapped file, valid as long as the reader
+    const void *read(std::uint64_t count, std::size_t elementSize);
+    // Throws when data is left after the last section
+    void finish() const;
+
+    // Checks that pre-order shape bytes describe exactly one tree of count nodes
+    static bool validTreeShape(const std::uint8_t *shapes, std::uint64_t count);
+
+    // Pre-order indices of both children of every node of a valid shape, count when missing
+    static void treeChildren(const std::uint8_t *shapes, std::uint64_t count,
+                             std::vector<std::uint64_t> &left, std::vector<std::uint64_t> &right);
+
+    // Checks that values stored in pre-order come out ordered when read in-order,
+    // n - 1 comparisons on top of a walk over the children
+    template <typename T, typename Compare>
+    static bool orderedTree(const char *values, const std::vector<std::uint64_t> &left,
+                            const std::vector<std::uint64_t> &right, const Compare &comp)
+    {
+        std::uint64_t count = left.size();
+        std::vector<std::uint64_t> path;
+        std::uint64_t node = 0;
+        bool first = true;
+        T previous{}, value{};
+
+        while (node != count || !path.empty()) {
+            while (node != count) {
+                path.push_back(node);
+                node = left[node];
+            }
+
+            node = path.back();
+            path.pop_back();
+
+            std::memcpy(&value, values + node * sizeof(T), sizeof(T));
+            if (!first && comp(value, previous))
+                return false;
+
+            previous = value;
+            first = false;
+            node = right[node];
+        }
+
+        return true;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <utility>
+
+#include "SpscQueue.hpp"
+
+template <typename T>
+SpscQueue<T>::SpscQueue(std::size_t capacity)
+{
+    std::size_t size = 1;
+    while (size < capacity)
+        size *= 2;
+
+    slots.resize(size);
+    mask = size - 1;
+}
+
+template <typename T>
+bool SpscQueue<T>::try_push(T &value)
+{
+    std::size_t index = tail.load(std::memory_order_relaxed);
+
+    if (index - cached_head == slots.size()) {
+        cached_head = head.load(std::memory_order_acquire);
+        if (index - cached_head == slots.size())
+            return false;
+    }
+
+    slots[index & mask] = std::move(value);
+    tail.store(index + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::try_pop(T &value)
+{
+    std::size_t index = head.load(std::memory_order_relaxed);
+
+    if (index == cached_tail) {
+        cached_tail = tail.load(std::memory_order_acquire);
+        if (index == cached_tail)
+            return false;
+    }
+
+    value = std::move(slots[index & mask]);
+    head.store(index + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T>
+std::size_t SpscQueue<T>::capacity() const
+{
+    return slots.size();
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Each side keeps a cached copy of the other index and reads the shared one only
+// when the cached value says the queue is full or empty.
+template <typename T>
+class SpscQueue
+{
+    // Keeps indices written by different threads on different cache lines
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    std::vector<T> slots;
+    std::size_t mask;
+
+    // Indices only grow, slot is the index masked with capacity - 1
+    alignas(CACHE_LINE) std::atomic<std::size_t> head{ 0 };
+    std::size_t cached_tail = 0;
+
+    alignas(CACHE_LINE) std::atomic<std::size_t> tail{ 0 };
+    std::size_t cached_head = 0;
+
+public:
+    // Capacity is rounded up to a power of two
+    SpscQueue(std::size_t capacity);
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // Producer side, value is moved into the queue only when it returns true
+    bool try_push(T &value);
+
+    // Consumer side, returns false when the queue is empty
+    bool try_pop(T &value);
+
+    std::size_t capacity() const;
+};
+
+// For template explicit instantiations
+#include "SpscQueue.cpp"
\ No newline at end of file
@@ -1,398 +1,2330 @@
 #include <chrono> 
+#include <cstdint>
 #include <iostream>
 #include <random>
 #include <algorithm>
+#include <array>
+#include <functional>
+#include <cctype>
+#include <limits>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif // __x86_64__ || __i386__
 
 #include "Array.hpp"
 #include "BinHeap.hpp"
+#include "PairingHeap.hpp"
+#include "RadixHeap.hpp"
 #include "List.hpp"
 #include "RBTree.hpp"
 #include "AVLTree.hpp"
+#include "PersistentRBTree.hpp"
+#include "Treap.hpp"
+#include "TreeMap.hpp"
+#include "LatencyHistogram.hpp"
+#include "Workload.hpp"
+#include "PerfCounters.hpp"
+#include "AllocationCounter.hpp"
+#include "CpuAffinity.hpp"
+#include "InterleavedLookup.hpp"
 
 using namespace std;
 
-static std::random_device rd;
-static std::default_random_engine generator(rd());
-
 class TimeBenchmark {
-    const size_t averagingLoopsCount = 10;
-    const size_t datasetGenerationCount = 100;
+    size_t averagingLoopsCount = 10;
+    size_t datasetGenerationCount = 100;
 
-    const std::vector<std::size_t> datasetSizesToTest =
+    std::vector<std::size_t> datasetSizesToTest =
     { 500, 1'000, 2'000, 5'000, 10'000, 25'000, 50'000, 100'000, 250'000 };
 
     size_t datasetSize = 500;
 
+    // Containers with linear time operations are skipped above this size
+    size_t linearCutoff = 25'000;
+
+    // Suite stops generating new datasets after this time, 0 means no limit
+    std::size_t timeBudgetMsec = 0;
+    std::uint64_t suiteStartNsec = 0;
+
+    // Names of containers and operations to run, empty runs everything
+    std::vector<std::string> containerFilter;
+    std::vector<std::string> operationFilter;
+
+    unsigned generatorSeed;
+
+    // Threads running suites at the same time, 0 uses every selected CPU
+    std::size_t jobsCount = 1;
+    // CPUs the threads are pinned to, one per thread, physical cores are picked when empty
+    std::vector<int> cpusToUse;
+
+    // Every suite is run for each pair of distribution and pattern
+    std::vector<KeyDistribution> keyDistributionsToTest = { KeyDistribution::UNIFORM };
+    std::vector<AccessPattern> accessPatternsToTest = { AccessPattern::RANDOM };
+
+    KeyDistribution keyDistribution = KeyDistribution::UNIFORM;
+    AccessPattern accessPattern = AccessPattern::RANDOM;
+
+    // Key range used by the push/pop workload
+    const int pushPopKeyRange = 1 << 20;
+    const int pushPopIncrementRange = 1 << 16;
+
     template <typename T>
     T randomNumberWithinRange(const T &first, const T &second)
     {
         std::uniform_int_distribution<T> distribution(first, second);
 
-        return distribution(generator);
+        return distribution(workload.engine());
     }
 
     typedef int datatype;
     typedef unsigned long long timedata;
 
-    class AveragedTimeMeasure {
-        std::chrono::high_resolution_clock::time_point start, end;
-        std::chrono::duration<double> elapsed = std::chrono::duration<double>::zero();
-        std::size_t times = 0;
+    Workload<datatype> workload;
 
-    public:
-        void benchmarkStart()
-        {
-            start = std::chrono::high_resolution_clock::now();
-        }
+public:
+    enum class TimingMode
+    {
+        // Clock is read around every single operation
+        PER_OPERATION,
+        // Clock is read around a whole burst of operations
+        BATCH
+    };
+
+    enum class ClockSource
+    {
+        CHRONO,
+        // Time stamp counter, falls back to chrono on other architectures
+        TSC
+    };
 
-        void benchmarkStop()
+    struct BenchResult
+    {
+        timedata mean = 0;
+        timedata p50 = 0;
+        timedata p99 = 0;
+        timedata p999 = 0;
+        timedata max = 0;
+        // Spread of per-dataset means, used for significance tests
+        double stddev = 0;
+        std::size_t repetitions = 0;
+        std::size_t operations = 0;
+        // Operations per second of measured time
+        double throughput = 0;
+        // Distribution is known only when single operations are timed
+        bool hasPercentiles = false;
+        // Mixed workloads are compared by throughput rather than mean
+        bool showThroughput = false;
+
+        // Hardware events per operation
+        std::array<double, PerfCounters::EVENTS_COUNT> counters{};
+        std::array<bool, PerfCounters::EVENTS_COUNT> hasCounter{};
+
+        // Heap use of timed operations
+        double allocationsPerOp = 0;
+        double allocatedBytesPerOp = 0;
+        // Live heap bytes of a filled container divided by its size, 0 if not measured
+        double bytesPerElement = 0;
+
+        friend std::ostream &operator<<(std::ostream &stream, const BenchResult &result)
         {
-            end = std::chrono::high_resolution_clock::now();
+            if (result.showThroughput)
+                stream << result.throughput / 1e6 << " Mops/s, ";
 
-            elapsed += end - start;
-            times++;
-        }
+            stream << result.mean << "ns";
 
-        timedata getAvgElapsedNsec()
-        {
-            return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / times;
+            if (result.hasPercentiles)
+                stream << "  (p50 " << result.p50 << "ns, p99 " << result.p99 << "ns, p99.9 "
+                    << result.p999 << "ns, max " << result.max << "ns)";
+
+            const char *separator = "\n    per operation: ";
+            for (int event = 0; event < PerfCounters::EVENTS_COUNT; event++) {
+                if (!result.hasCounter[event])
+                    continue;
+
+                stream << separator << PerfCounters::name((PerfCounters::Event)event) << ' '
+                    << result.counters[event];
+                separator = ", ";
+            }
+
+            if (result.allocationsPerOp || result.bytesPerElement) {
+                stream << "\n    memory: " << result.allocationsPerOp << " allocs/op, "
+                    << result.allocatedBytesPerOp << " B allocated/op";
+
+                if (result.bytesPerElement)
+                    stream << ", " << result.bytesPerElement << " B/element";
+            }
+
+            return stream;
         }
     };
 
-    template < typename T>
-    std::vector<T> generateRandomData(std::size_t datasetSize)
+    // Percentages of contains, add and remove operations
+    struct OperationMix
     {
-        std::vector<T> dataset;
+        unsigned contains;
+        unsigned add;
+        unsigned remove;
 
-        for (int i = 0; i < datasetSize; i++) {
-            dataset.push_back(randomNumberWithinRange(INT_MIN, INT_MAX));
+        std::string name() const
+        {
+            return "mix_" + std::to_string(contains) + '_' + std::to_string(add) + '_' + std::to_string(remove);
         }
+    };
 
-        // Remove any duplicates
-        std::vector<datatype>::iterator last = std::unique(dataset.begin(), dataset.end());
-        while (last != dataset.end()) {
-            while (last != dataset.end()) {
-                (*last++) = randomNumberWithinRange(INT_MIN, INT_MAX);
-            }
+    // Container and operation names given by the user are matched ignoring case
+    static bool equalIgnoreCase(const std::string &first, const std::string &second)
+    {
+        return first.size() == second.size() &&
+            std::equal(first.begin(), first.end(), second.begin(),
+                       [](char a, char b) { return std::tolower(a) == std::tolower(b); });
+    }
 
-            last = std::unique(dataset.begin(), dataset.end());
-        }
+    // Parses "contains:add:remove", e.g. 90:5:5
+    static OperationMix parseOperationMix(const std::string &text)
+    {
+        OperationMix mix;
+        char first, second;
+        std::istringstream stream(text);
 
-        return dataset;
+        if (!(stream >> mix.contains >> first >> mix.add >> second >> mix.remove) || first != ':' ||
+            second != ':' || !stream.eof() || mix.contains + mix.add + mix.remove == 0)
+            throw std::invalid_argument("Invalid operation mix: " + text);
+
+        return mix;
     }
 
-    template < typename T>
-    T getRandomValueFromDatasetAndRemove(std::vector<T> &dataset)
+    enum class OutputFormat
     {
-        std::size_t pos = randomNumberWithinRange((std::size_t)0, dataset.size() - 1);
+        // Aligned lines for reading
+        TEXT,
+        CSV,
+        JSON
+    };
 
-        dataset.erase(dataset.begin() + pos);
+private:
+    TimingMode timingMode;
+    ClockSource clockSource;
 
-        return dataset[pos];
-    }
+    OutputFormat outputFormat = OutputFormat::TEXT;
+    // Results go to stdout when empty
+    std::string outputPath;
+    // Results file of a previous run to compare against, CSV only
+    std::string comparePath;
 
-    template <template <typename> typename T, typename D>
-    timedata benchmarkSuiteAdd(std::function<void(T<D> &, D)> containerFunc)
+    // Change smaller than this is never reported, even if significant
+    const double compareRelativeThreshold = 0.05;
+
+    struct ReportRow
     {
-        AveragedTimeMeasure containerTimeAveraging;
+        std::string container;
+        std::string operation;
+        std::string keys;
+        std::string access;
+        std::size_t datasetSize;
+        BenchResult result;
+    };
 
-        for (std::size_t j = 0; j < datasetGenerationCount; j++) {
-            auto dataset = generateRandomData<D>(datasetSize);
+    std::vector<ReportRow> reportRows;
 
-            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
-                T<D> container;
-                for (const auto &val : dataset) {
-                    containerTimeAveraging.benchmarkStart();
-                    containerFunc(container, val);
-                    containerTimeAveraging.benchmarkStop();
-                }
-            }
+    // Operation as in menu: a - add, x - remove, c - contains
+    struct TraceOperation
+    {
+        char type;
+        datatype value;
+    };
+
+    std::vector<OperationMix> operationMixes = { { 90, 5, 5 } };
+
+    // Replayed on every container when not empty
+    std::string tracePath;
+    std::vector<TraceOperation> trace;
+
+    // Cost of an empty timed operation, subtracted from every result
+    double baselineNsec = 0;
+
+    // Harness work left inside timed loops above this is reported as a warning
+    const double harnessOverheadLimitNsec = 2.0;
+
+    bool countersEnabled = false;
+    // Counters of the running suite, counting around timed loops
+    PerfCounters *activeCounters = nullptr;
+    // Events of an empty timed operation, subtracted like baselineNsec
+    std::array<double, PerfCounters::EVENTS_COUNT> counterBaseline{};
+
+    static std::uint64_t readClock(ClockSource source)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        if (source == ClockSource::TSC) {
+            unsigned int aux;
+            return __rdtscp(&aux);
         }
-        return containerTimeAveraging.getAvgElapsedNsec();
+#endif // __x86_64__ || __i386__
+
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
     }
 
-    template <typename D>
-    timedata benchmarkSuiteListInsert()
+    static double clockNsecPerTick(ClockSource source)
     {
-        AveragedTimeMeasure containerTimeAveraging;
+        if (source == ClockSource::CHRONO)
+            return 1.0;
 
-        for (std::size_t j = 0; j < datasetGenerationCount; j++) {
-            auto dataset = generateRandomData<D>(datasetSize);
+        // Measure TSC frequency against chrono once
+        static double nsecPerTick = [] {
+            auto chronoStart = readClock(ClockSource::CHRONO);
+            auto tscStart = readClock(ClockSource::TSC);
 
-            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
-                List<D> container;
+            while (readClock(ClockSource::CHRONO) - chronoStart < 50'000'000);
 
-                // Push first element
-                container.push_back(dataset[0]);
+            auto chronoElapsed = readClock(ClockSource::CHRONO) - chronoStart;
+            auto tscElapsed = readClock(ClockSource::TSC) - tscStart;
 
-                for (size_t datasetAt = 1; datasetAt < datasetSize; datasetAt++) {
-                    auto insertAt = randomNumberWithinRange((size_t)0, datasetAt - 1);
-                    auto *node = container.get_node(dataset[insertAt]);
+            return (double)chronoElapsed / tscElapsed;
+        }();
 
-                    containerTimeAveraging.benchmarkStart();
-                    container.insert(dataset[datasetAt], node);
-                    containerTimeAveraging.benchmarkStop();
-                }
-            }
-        }
-        return containerTimeAveraging.getAvgElapsedNsec();
+        return nsecPerTick;
     }
 
-    template <typename D>
-    timedata benchmarkSuiteArrayInsert()
+    // Keeps the compiler from optimizing away the computation of a value
+    template <typename T>
+    static inline void doNotOptimize(const T &value)
     {
-        AveragedTimeMeasure containerTimeAveraging;
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
 
-        for (std::size_t j = 0; j < datasetGenerationCount; j++) {
-            auto dataset = generateRandomData<D>(datasetSize);
+    class AveragedTimeMeasure {
+        ClockSource clockSource;
+        double baselineNsec;
+        // Values handled by one timed operation, results are reported per value
+        std::size_t valuesPerOperation;
 
-            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
-                Array<D> container;
+        std::uint64_t start = 0;
+        std::uint64_t elapsed = 0;
+        std::size_t times = 0;
 
-                // Push first element
-                container.push_back(dataset[0]);
+        // Latencies of single operations in clock ticks
+        LatencyHistogram histogram;
 
-                for (size_t datasetAt = 1; datasetAt < datasetSize; datasetAt++) {
-                    auto insertAt = randomNumberWithinRange((size_t)0, datasetAt - 1);
+        // Running mean and variance of per-repetition means (Welford)
+        std::uint64_t repetitionStartElapsed = 0;
+        std::size_t repetitionStartTimes = 0;
+        std::size_t repetitions = 0;
+        double repetitionMean = 0;
+        double repetitionM2 = 0;
 
-                    containerTimeAveraging.benchmarkStart();
-                    container.insert(dataset[datasetAt], insertAt);
-                    containerTimeAveraging.benchmarkStop();
-                }
+        std::uint64_t allocations = 0;
+        std::uint64_t allocatedBytes = 0;
+
+        std::int64_t footprintBytes = 0;
+        std::size_t footprintElements = 0;
+
+        timedata ticksToNsec(std::uint64_t ticks) const
+        {
+            return std::max(ticks * clockNsecPerTick(clockSource) - baselineNsec, 0.0) + 0.5;
+        }
+
+    public:
+        AveragedTimeMeasure(ClockSource clockSource, double baselineNsec, std::size_t valuesPerOperation = 1) :
+            clockSource(clockSource), baselineNsec(baselineNsec / valuesPerOperation),
+            valuesPerOperation(valuesPerOperation)
+        {
+        }
+
+        void benchmarkStart()
+        {
+            start = readClock(clockSource);
+        }
+
+        // Operations is the number of operations done since benchmarkStart
+        void benchmarkStop(std::size_t operations = 1)
+        {
+            std::uint64_t ticks = readClock(clockSource) - start;
+
+            elapsed += ticks;
+            times += operations * valuesPerOperation;
+
+            if (operations == 1)
+                histogram.record((ticks + valuesPerOperation / 2) / valuesPerOperation);
+        }
+
+        double getAvgElapsedNsecRaw() const
+        {
+            return times ? elapsed * clockNsecPerTick(clockSource) / times : 0;
+        }
+
+        timedata getAvgElapsedNsec() const
+        {
+            return std::max(getAvgElapsedNsecRaw() - baselineNsec, 0.0) + 0.5;
+        }
+
+        void addAllocations(const AllocationCounter::Snapshot &before, const AllocationCounter::Snapshot &after)
+        {
+            allocations += after.allocations - before.allocations;
+            allocatedBytes += after.allocatedBytes - before.allocatedBytes;
+        }
+
+        // Live bytes held by a container with given number of elements
+        void addFootprint(std::int64_t bytes, std::size_t elements)
+        {
+            footprintBytes += bytes;
+            footprintElements += elements;
+        }
+
+        // Closes a repetition, usually one generated dataset
+        void finishRepetition()
+        {
+            std::size_t operations = times - repetitionStartTimes;
+            if (operations == 0)
+                return;
+
+            double mean = (elapsed - repetitionStartElapsed) * clockNsecPerTick(clockSource) / operations;
+            mean = std::max(mean - baselineNsec, 0.0);
+
+            repetitions++;
+            double delta = mean - repetitionMean;
+            repetitionMean += delta / repetitions;
+            repetitionM2 += delta * (mean - repetitionMean);
+
+            repetitionStartElapsed = elapsed;
+            repetitionStartTimes = times;
+        }
+
+        BenchResult getResult() const
+        {
+            BenchResult result;
+            result.mean = getAvgElapsedNsec();
+            result.operations = times;
+            result.repetitions = repetitions;
+            result.stddev = repetitions > 1 ? std::sqrt(repetitionM2 / (repetitions - 1)) : 0;
+
+            double meanNsec = std::max(getAvgElapsedNsecRaw() - baselineNsec, 0.0);
+            result.throughput = meanNsec > 0 ? 1e9 / meanNsec : 0;
+
+            if (times) {
+                result.allocationsPerOp = (double)allocations / times;
+                result.allocatedBytesPerOp = (double)allocatedBytes / times;
             }
+            if (footprintElements)
+                result.bytesPerElement = (double)footprintBytes / footprintElements;
+
+            // Batches mixed with single operations would skew the distribution
+            if (histogram.count() != 0 && histogram.count() * valuesPerOperation == times) {
+                result.p50 = ticksToNsec(histogram.percentile(50));
+                result.p99 = ticksToNsec(histogram.percentile(99));
+                result.p999 = ticksToNsec(histogram.percentile(99.9));
+                result.max = ticksToNsec(histogram.max());
+                result.hasPercentiles = true;
+            }
+
+            return result;
         }
-        return containerTimeAveraging.getAvgElapsedNsec();
+    };
+
+    AveragedTimeMeasure makeTimeMeasure(std::size_t valuesPerOperation = 1) const
+    {
+        return AveragedTimeMeasure(clockSource, baselineNsec, valuesPerOperation);
     }
 
-    template <template <typename> typename T, typename D>
-    timedata benchmarkSuiteSearch(std::function<void(T<D> &, D)> containerFunc)
+    // Runs operation(0) ... operation(count - 1), only the operations themselves are timed
+    template <typename F>
+    void timeOperations(AveragedTimeMeasure &measure, std::size_t count, F &&operation)
     {
-        AveragedTimeMeasure containerTimeAveraging;
+        if (count == 0)
+            return;
 
-        for (std::size_t j = 0; j < datasetGenerationCount; j++) {
-            auto dataset = generateRandomData<D>(datasetSize);
-            T<D> container;
+        auto allocationsBefore = AllocationCounter::snapshot();
 
-            // Prepare container for testing
-            for (const auto &val : dataset)
-                containerFunc(container, val);
+        if (activeCounters)
+            activeCounters->start();
 
-            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
-                while (!dataset.empty()) {
-                    auto value = getRandomValueFromDatasetAndRemove(dataset);
-                    containerTimeAveraging.benchmarkStart();
-                    // Hack to force GCC to not skip this call during optimization
-                    volatile auto tmp = container.contains(value);
-                    if (!tmp)
-                        throw std::runtime_error("nope");
-                    containerTimeAveraging.benchmarkStop();
-                }
+        if (timingMode == TimingMode::BATCH) {
+            measure.benchmarkStart();
+            for (std::size_t i = 0; i < count; i++)
+                operation(i);
+            measure.benchmarkStop(count);
+        }
+        else {
+            for (std::size_t i = 0; i < count; i++) {
+                measure.benchmarkStart();
+                operation(i);
+                measure.benchmarkStop();
             }
         }
-        return containerTimeAveraging.getAvgElapsedNsec();
+
+        if (activeCounters)
+            activeCounters->stop();
+
+        measure.addAllocations(allocationsBefore, AllocationCounter::snapshot());
     }
 
-    template <template <typename> typename T, typename D>
-    timedata benchmarkSuiteRemove(std::function<void(T<D> &, D)> containerFunc)
+    // Measure cost of the timing loop with an empty operation
+    void calibrateBaseline()
     {
-        AveragedTimeMeasure containerTimeAveraging;
-
-        for (std::size_t j = 0; j < datasetGenerationCount; j++) {
-            auto dataset = generateRandomData<D>(datasetSize);
+        const std::size_t operationsCount = 10'000;
 
-            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
-                T<D> container;
+        baselineNsec = 0;
+        double best = -1;
 
-                // Prepare container for testing
-                for (const auto &val : dataset)
-                    containerFunc(container, val);
+        for (std::size_t i = 0; i < 100; i++) {
+            AveragedTimeMeasure measure = makeTimeMeasure();
+            timeOperations(measure, operationsCount, [](std::size_t i) { doNotOptimize(i); });
 
-                while (!dataset.empty()) {
-                    auto value = getRandomValueFromDatasetAndRemove(dataset);
-                    containerTimeAveraging.benchmarkStart();
-                    container.remove(value);
-                    containerTimeAveraging.benchmarkStop();
-                }
-            }
+            if (best < 0 || measure.getAvgElapsedNsecRaw() < best)
+                best = measure.getAvgElapsedNsecRaw();
         }
-        return containerTimeAveraging.getAvgElapsedNsec();
+
+        baselineNsec = best;
+
+        if (!countersEnabled)
+            return;
+
+        PerfCounters counters;
+        AveragedTimeMeasure measure = makeTimeMeasure();
+
+        activeCounters = &counters;
+        for (std::size_t i = 0; i < 100; i++)
+            timeOperations(measure, operationsCount, [](std::size_t i) { doNotOptimize(i); });
+        activeCounters = nullptr;
+
+        for (int event = 0; event < PerfCounters::EVENTS_COUNT; event++)
+            counterBaseline[event] = counters.count((PerfCounters::Event)event) / (100 * operationsCount);
     }
 
-    template <template <typename> typename T, typename D>
-    timedata benchmarkSuiteRemoveFunc(std::function<void(T<D> &, D)> containerFuncAdd,
-                                      std::function<void(T<D> &)> containerFuncRemove)
+    // Runs a suite and attaches hardware events per operation when enabled
+    BenchResult runSuite(const std::function<BenchResult()> &suite)
     {
-        AveragedTimeMeasure containerTimeAveraging;
+        suiteStartNsec = readClock(ClockSource::CHRONO);
 
-        for (std::size_t j = 0; j < datasetGenerationCount; j++) {
-            auto dataset = generateRandomData<D>(datasetSize);
+        if (!countersEnabled)
+            return suite();
 
-            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
-                T<D> container;
+        PerfCounters counters;
 
-                // Prepare container for testing
-                for (const auto &val : dataset)
-                    containerFuncAdd(container, val);
+        activeCounters = &counters;
+        BenchResult result = suite();
+        activeCounters = nullptr;
 
-                for (const auto &val : dataset) {
-                    containerTimeAveraging.benchmarkStart();
-                    containerFuncRemove(container);
-                    containerTimeAveraging.benchmarkStop();
-                }
-            }
+        for (int event = 0; event < PerfCounters::EVENTS_COUNT; event++) {
+            if (!counters.available((PerfCounters::Event)event) || result.operations == 0)
+                continue;
+
+            result.counters[event] = std::max(counters.count((PerfCounters::Event)event) / result.operations -
+                                              counterBaseline[event], 0.0);
+            result.hasCounter[event] = true;
         }
-        return containerTimeAveraging.getAvgElapsedNsec();
+
+        return result;
     }
 
+    // Container that does nothing, suites run on it time only their own bookkeeping
     template <typename D>
-    timedata benchmarkSuiteRemoveList(std::function<void(List<D> &, D)> containerFunc)
+    struct NoopContainer
     {
-        AveragedTimeMeasure containerTimeAveraging;
-
-        for (std::size_t j = 0; j < datasetGenerationCount; j++) {
-            auto dataset = generateRandomData<D>(datasetSize);
-
-            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
-                List<D> container;
+        void add(const D &value)
+        {
+            doNotOptimize(value);
+        }
 
-                // Prepare container for testing
-                for (const auto &val : dataset)
-                    containerFunc(container, val);
+        bool contains(const D &value) const
+        {
+            doNotOptimize(value);
+            return true;
+        }
 
-                while (!dataset.empty()) {
-                    auto value = getRandomValueFromDatasetAndRemove(dataset);
-                    // Node lookup time isnt taken into account
-                    auto node = container.get_node(value);
+        bool remove(const D &value)
+        {
+            doNotOptimize(value);
+            return true;
+        }
+    };
 
-                    containerTimeAveraging.benchmarkStart();
-                    container.remove(node);
-                    containerTimeAveraging.benchmarkStop();
-                }
+    // Runs the add, contains and remove suites on NoopContainer with the largest dataset
+    // and the first key distribution and access pattern. Like the baseline each suite
+    // keeps its best of several runs, the largest time per operation left after the
+    // baseline is returned
+    double measureHarnessOverhead()
+    {
+        keyDistribution = keyDistributionsToTest.front();
+        accessPattern = accessPatternsToTest.front();
+        datasetSize = *std::max_element(datasetSizesToTest.begin(), datasetSizesToTest.end());
+        workload.engine().seed(generatorSeed);
+
+        // One dataset per run, the container takes no time
+        std::size_t datasetCount = datasetGenerationCount;
+        datasetGenerationCount = 1;
+
+        auto noop_add_lambda = [](NoopContainer<datatype> &container, const datatype &val) { container.add(val); };
+        std::array<std::function<BenchResult()>, 3> suites = {
+            [&] { return benchmarkSuiteAdd<NoopContainer, datatype>(noop_add_lambda); },
+            [&] { return benchmarkSuiteSearch<NoopContainer, datatype>(noop_add_lambda); },
+            [&] { return benchmarkSuiteRemove<NoopContainer, datatype>(noop_add_lambda); },
+        };
+
+        double worst = 0;
+        for (const auto &suite : suites) {
+            double best = -1;
+
+            for (std::size_t i = 0; i < 5; i++) {
+                suiteStartNsec = readClock(ClockSource::CHRONO);
+                BenchResult result = suite();
+
+                // Throughput is kept from the mean before rounding to whole nanoseconds
+                double overhead = result.throughput > 0 ? 1e9 / result.throughput : 0;
+                if (best < 0 || overhead < best)
+                    best = overhead;
             }
+
+            worst = std::max(worst, best);
         }
-        return containerTimeAveraging.getAvgElapsedNsec();
+
+        datasetGenerationCount = datasetCount;
+
+        return worst;
     }
 
-public:
-    void run()
+    bool moreRepetitions(std::size_t repetition) const
     {
-        auto array_push_back_lambda =
-            [](Array<datatype> &array, const datatype &val) { array.push_back(val); };
-        auto array_push_front_lambda =
-            [](Array<datatype> &array, const datatype &val) { array.push_front(val); };
-
-        auto list_push_back_lambda =
-            [](List<datatype> &list, const datatype &val) { list.push_back(val); };
-        auto list_push_front_lambda =
-            [](List<datatype> &list, const datatype &val) { list.push_front(val); };
+        if (repetition >= datasetGenerationCount)
+            return false;
 
-        auto binheap_add_lambda =
-            [](BinHeap<datatype> &binheap, const datatype &val) { binheap.add(val); };
+        // At least one dataset is always measured
+        if (repetition == 0 || timeBudgetMsec == 0)
+            return true;
 
-        auto rbtree_add_lambda =
-            [](RBTree<datatype> &rbtree, const datatype &val) { rbtree.add(val); };
+        return readClock(ClockSource::CHRONO) - suiteStartNsec < timeBudgetMsec * 1'000'000;
+    }
 
-        auto avltree_add_lambda =
-            [](AVLTree<datatype> &avltree, const datatype &val) { avltree.add(val); };
+    std::vector<datatype> generateDataset(datatype min = std::numeric_limits<datatype>::min(),
+                                          datatype max = std::numeric_limits<datatype>::max())
+    {
+        return workload.keys(keyDistribution, datasetSize, min, max);
+    }
 
-        auto array_pop_back_lambda =
-            [](Array<datatype> &array) { array.pop_back(); };
-        auto array_pop_front_lambda =
-            [](Array<datatype> &array) { array.pop_front(); };
+    // Dataset values in the order given by the access pattern, drawn before the timed region
+    std::vector<datatype> accessValues(const std::vector<datatype> &dataset, bool distinct)
+    {
+        std::vector<datatype> values;
 
-        auto list_pop_back_lambda =
-            [](List<datatype> &list) { list.pop_back(); };
-        auto list_pop_front_lambda =
-            [](List<datatype> &list) { list.pop_front(); };
+        for (auto index : workload.accessOrder(accessPattern, dataset, distinct))
+            values.push_back(dataset[index]);
 
-        for (auto &datasetSizeToTest : datasetSizesToTest) {
-            datasetSize = datasetSizeToTest;
-            std::cout << "Testing dataset at size: " << datasetSizeToTest << "\n//////////////\n";
+        return values;
+    }
 
-            if (datasetSize <= 25'000) {
-                // Add
-                cout << "Array push_back:  " << benchmarkSuiteAdd<Array, datatype>(array_push_back_lambda) << "ns\n";
-                cout << "Array push_front: " << benchmarkSuiteAdd<Array, datatype>(array_push_front_lambda) << "ns\n";
+    template <template <typename> typename T, typename D, typename AddFunc>
+    BenchResult benchmarkSuiteAdd(AddFunc containerFunc)
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
 
-                cout << "List push_back:   " << benchmarkSuiteAdd<List, datatype>(list_push_back_lambda) << "ns\n";
-                cout << "List push_front:  " << benchmarkSuiteAdd<List, datatype>(list_push_front_lambda) << "ns\n";
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
 
-                cout << "BinHeap add:      " << benchmarkSuiteAdd<BinHeap, datatype>(binheap_add_lambda) << "ns\n";
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                auto liveBytesBefore = AllocationCounter::snapshot().liveBytes;
+                T<D> container;
 
-                cout << "Rbtree add:       " << benchmarkSuiteAdd<RBTree, datatype>(rbtree_add_lambda) << "ns\n";
+                timeOperations(containerTimeAveraging, dataset.size(),
+                               [&](std::size_t k) { containerFunc(container, dataset[k]); });
 
-                cout << "Avltree add:      " << benchmarkSuiteAdd<AVLTree, datatype>(avltree_add_lambda) << "ns\n";
+                containerTimeAveraging.addFootprint(AllocationCounter::snapshot().liveBytes - liveBytesBefore,
+                                                    dataset.size());
+            }
 
-                cout << endl;
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
 
-                // Insert
-                cout << "Array insert:     " << benchmarkSuiteArrayInsert<datatype>() << "ns\n";
+    template <typename D>
+    BenchResult benchmarkSuiteListInsert()
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
 
-                cout << "List insert ref:  " << benchmarkSuiteListInsert<datatype>() << "ns\n";
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            std::vector<std::size_t> insertAt(datasetSize);
 
-                cout << endl;
+            // Node for every value is known as soon as it is inserted,
+            // so positions can be drawn before the timed region
+            for (size_t datasetAt = 1; datasetAt < datasetSize; datasetAt++)
+                insertAt[datasetAt] = randomNumberWithinRange((size_t)0, datasetAt - 1);
 
-                // Contains
-                cout << "Array contains:   " << benchmarkSuiteSearch<Array, datatype>(array_push_back_lambda) << "ns\n";
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                List<D> container;
+                std::vector<typename List<D>::Node *> nodes(datasetSize);
 
-                cout << "List contains:    " << benchmarkSuiteSearch<List, datatype>(list_push_back_lambda) << "ns\n";
+                // Push first element
+                nodes[0] = container.push_back(dataset[0]);
 
-                cout << "BinHeap contains: " << benchmarkSuiteSearch<BinHeap, datatype>(binheap_add_lambda) << "ns\n";
+                timeOperations(containerTimeAveraging, datasetSize - 1, [&](std::size_t k) {
+                    nodes[k + 1] = container.insert(dataset[k + 1], nodes[insertAt[k + 1]]);
+                });
+            }
 
-                cout << "Rbtree contains:  " << benchmarkSuiteSearch<RBTree, datatype>(rbtree_add_lambda) << "ns\n";
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
 
-                cout << "Avltree contains: " << benchmarkSuiteSearch<AVLTree, datatype>(avltree_add_lambda) << "ns\n";
+    template <typename D>
+    BenchResult benchmarkSuiteArrayInsert()
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
 
-                cout << endl;
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            std::vector<std::size_t> insertAt(datasetSize);
 
-                // Remove
-                cout << "Array remove:     " << benchmarkSuiteRemove<Array, datatype>(array_push_back_lambda) << "ns\n";
+            for (size_t datasetAt = 1; datasetAt < datasetSize; datasetAt++)
+                insertAt[datasetAt] = randomNumberWithinRange((size_t)0, datasetAt - 1);
 
-                cout << "Array pop_back:   " <<
-                    benchmarkSuiteRemoveFunc<Array, datatype>(array_push_back_lambda, array_pop_back_lambda)
-                    << "ns\n";
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                Array<D> container;
 
-                cout << "Array pop_front:  " <<
-                    benchmarkSuiteRemoveFunc<Array, datatype>(array_push_back_lambda, array_pop_front_lambda)
-                    << "ns\n";
+                // Push first element
+                container.push_back(dataset[0]);
 
-                cout << "List pop_back:    " <<
-                    benchmarkSuiteRemoveFunc<List, datatype>(list_push_back_lambda, list_pop_back_lambda)
-                    << "ns\n";
+                timeOperations(containerTimeAveraging, datasetSize - 1, [&](std::size_t k) {
+                    container.insert(dataset[k + 1], insertAt[k + 1]);
+                });
+            }
 
-                cout << "List pop_front:   " <<
-                    benchmarkSuiteRemoveFunc<List, datatype>(list_push_back_lambda, list_pop_front_lambda)
-                    << "ns\n";
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
 
-                cout << "List remove val:  " << benchmarkSuiteRemove<List, datatype>(list_push_back_lambda) << "ns\n";
+    template <template <typename> typename T, typename D, typename AddFunc>
+    BenchResult benchmarkSuiteSearch(AddFunc containerFunc)
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
 
-                cout << "List remove ref:  " << benchmarkSuiteRemoveList<datatype>(list_push_back_lambda) << "ns\n";
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            T<D> container;
 
-                cout << "BinHeap remove:   " << benchmarkSuiteRemove<BinHeap, datatype>(binheap_add_lambda) << "ns\n";
+            // Prepare container for testing
+            for (const auto &val : dataset)
+                containerFunc(container, val);
 
-                cout << "Rbtree remove:    " << benchmarkSuiteRemove<RBTree, datatype>(rbtree_add_lambda) << "ns\n";
+            auto order = accessValues(dataset, false);
 
-                cout << "Avltree remove:   " << benchmarkSuiteRemove<AVLTree, datatype>(avltree_add_lambda) << "ns\n";
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                timeOperations(containerTimeAveraging, order.size(), [&](std::size_t k) {
+                    if (!container.contains(order[k]))
+                        throw std::runtime_error("nope");
+                });
             }
-            else {
-                cout << "Rbtree add:       " << benchmarkSuiteAdd<RBTree, datatype>(rbtree_add_lambda) << "ns\n";
-
-                cout << "Avltree add:      " << benchmarkSuiteAdd<AVLTree, datatype>(avltree_add_lambda) << "ns\n";
 
-                cout << endl;
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
 
-                cout << "Rbtree contains:  " << benchmarkSuiteSearch<RBTree, datatype>(rbtree_add_lambda) << "ns\n";
+    // Looks values up through contains_many, times are reported per value
+    template <template <typename> typename T, typename D, typename AddFunc>
+    BenchResult benchmarkSuiteSearchMany(AddFunc containerFunc)
+    {
+        const std::size_t batchSize = 256;
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure(batchSize);
 
-                cout << "Avltree contains: " << benchmarkSuiteSearch<AVLTree, datatype>(avltree_add_lambda) << "ns\n";
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            T<D> container;
 
-                cout << endl;
+            // Prepare container for testing
+            for (const auto &val : dataset)
+                containerFunc(container, val);
 
-                cout << "Rbtree remove:    " << benchmarkSuiteRemove<RBTree, datatype>(rbtree_add_lambda) << "ns\n";
+            auto order = accessValues(dataset, false);
+            bool results[batchSize];
 
-                cout << "Avltree remove:   " << benchmarkSuiteRemove<AVLTree, datatype>(avltree_add_lambda) << "ns\n";
+            // Values past the last full batch are left out
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                timeOperations(containerTimeAveraging, order.size() / batchSize, [&](std::size_t k) {
+                    if (container.contains_many(&order[k * batchSize], batchSize, results) != batchSize)
+                        throw std::runtime_error("nope");
+                });
             }
 
-            cout << "\\\\\\\\\\\\\\\\\\\\\\\\\\\n" << endl;
+            containerTimeAveraging.finishRepetition();
         }
+        return containerTimeAveraging.getResult();
+    }
+
+#ifdef INTERLEAVED_LOOKUP
+    // Coroutine lookups with given number of them in flight, reported as throughput
+    template <template <typename> typename T, typename D, typename AddFunc>
+    BenchResult benchmarkSuiteSearchInterleaved(AddFunc containerFunc, std::size_t width)
+    {
+        const std::size_t batchSize = 256;
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure(batchSize);
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            T<D> container;
+
+            // Prepare container for testing
+            for (const auto &val : dataset)
+                containerFunc(container, val);
+
+            auto order = accessValues(dataset, false);
+            InterleavedLookup<T<D>> lookup(container, width);
+            bool results[batchSize];
+
+            // Values past the last full batch are left out
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                timeOperations(containerTimeAveraging, order.size() / batchSize, [&](std::size_t k) {
+                    if (lookup.contains(&order[k * batchSize], batchSize, results) != batchSize)
+                        throw std::runtime_error("nope");
+                });
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+
+        BenchResult result = containerTimeAveraging.getResult();
+        result.showThroughput = true;
+        return result;
+    }
+
+    // Coroutine successor queries of present values, each must land on an equal value
+    template <template <typename> typename T, typename D, typename AddFunc>
+    BenchResult benchmarkSuiteLowerBoundInterleaved(AddFunc containerFunc, std::size_t width)
+    {
+        const std::size_t batchSize = 256;
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure(batchSize);
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            T<D> container;
+
+            // Prepare container for testing
+            for (const auto &val : dataset)
+                containerFunc(container, val);
+
+            auto order = accessValues(dataset, false);
+            InterleavedLookup<T<D>> lookup(container, width);
+            const typename T<D>::Node *results[batchSize];
+
+            // Values past the last full batch are left out
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                timeOperations(containerTimeAveraging, order.size() / batchSize, [&](std::size_t k) {
+                    const D *values = &order[k * batchSize];
+                    lookup.lower_bound(values, batchSize, results);
+
+                    for (std::size_t l = 0; l < batchSize; l++)
+                        if (!results[l] || results[l]->value != values[l])
+                            throw std::runtime_error("nope");
+                });
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+
+        BenchResult result = containerTimeAveraging.getResult();
+        result.showThroughput = true;
+        return result;
+    }
+
+    // Coroutine range counts over spans of neighbouring dataset values, totals of every
+    // batch are known before the timed region
+    template <template <typename> typename T, typename D, typename AddFunc>
+    BenchResult benchmarkSuiteCountRangeInterleaved(AddFunc containerFunc, std::size_t width)
+    {
+        const std::size_t batchSize = 256;
+        const std::size_t rangeSpan = 8;
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure(batchSize);
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            T<D> container;
+
+            // Prepare container for testing
+            for (const auto &val : dataset)
+                containerFunc(container, val);
+
+            auto sorted = dataset;
+            std::sort(sorted.begin(), sorted.end());
+
+            // Range starts at each accessed value and spans the following sorted values
+            auto order = accessValues(dataset, false);
+            std::vector<D> low(order.size()), high(order.size());
+            std::vector<std::size_t> expected(order.size() / batchSize);
+            std::size_t last = sorted.size() - std::min(rangeSpan, sorted.size());
+
+            for (std::size_t k = 0; k < order.size(); k++) {
+                std::size_t first = std::lower_bound(sorted.begin(), sorted.end(), order[k]) - sorted.begin();
+                first = std::min(first, last);
+
+                low[k] = sorted[first];
+                high[k] = sorted[first + std::min(rangeSpan, sorted.size()) - 1];
+                if (k / batchSize < expected.size())
+                    expected[k / batchSize] += std::upper_bound(sorted.begin(), sorted.end(), high[k]) -
+                                               std::lower_bound(sorted.begin(), sorted.end(), low[k]);
+            }
+
+            InterleavedLookup<T<D>> lookup(container, width);
+            std::size_t results[batchSize];
+
+            // Values past the last full batch are left out
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                timeOperations(containerTimeAveraging, expected.size(), [&](std::size_t k) {
+                    if (lookup.count_range(&low[k * batchSize], &high[k * batchSize], batchSize, results) !=
+                        expected[k])
+                        throw std::runtime_error("nope");
+                });
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+
+        BenchResult result = containerTimeAveraging.getResult();
+        result.showThroughput = true;
+        return result;
+    }
+#endif // INTERLEAVED_LOOKUP
+
+    template <template <typename> typename T, typename D, typename AddFunc>
+    BenchResult benchmarkSuiteRemove(AddFunc containerFunc)
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            auto order = accessValues(dataset, true);
+
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                T<D> container;
+
+                // Prepare container for testing
+                for (const auto &val : dataset)
+                    containerFunc(container, val);
+
+                timeOperations(containerTimeAveraging, order.size(),
+                               [&](std::size_t k) { container.remove(order[k]); });
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
+
+    // Chunks of neighbouring distinct values in random order, times are reported per value.
+    // Container is filled with the same distinct values first when ranges are erased, so
+    // every range operation handles exactly rangeSize elements whatever the key distribution
+    template <template <typename> typename T, typename D, typename AddFunc, typename RangeFunc>
+    BenchResult benchmarkSuiteRange(AddFunc containerFunc, RangeFunc containerFuncRange, bool fill)
+    {
+        const std::size_t rangeSize = 64;
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure(rangeSize);
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto sorted = generateDataset();
+            std::sort(sorted.begin(), sorted.end());
+            sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+            auto distinct = sorted;
+            std::shuffle(distinct.begin(), distinct.end(), workload.engine());
+
+            // Values past the last full range are left out
+            std::vector<std::size_t> ranges(sorted.size() / rangeSize);
+            for (std::size_t k = 0; k < ranges.size(); k++)
+                ranges[k] = k * rangeSize;
+            std::shuffle(ranges.begin(), ranges.end(), workload.engine());
+
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                T<D> container;
+
+                // Prepare container for testing
+                if (fill)
+                    for (const auto &val : distinct)
+                        containerFunc(container, val);
+
+                timeOperations(containerTimeAveraging, ranges.size(), [&](std::size_t k) {
+                    containerFuncRange(container, &sorted[ranges[k]], rangeSize);
+                });
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
+
+    template <template <typename> typename T, typename D, typename AddFunc, typename RemoveFunc>
+    BenchResult benchmarkSuiteRemoveFunc(AddFunc containerFuncAdd, RemoveFunc containerFuncRemove)
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                T<D> container;
+
+                // Prepare container for testing
+                for (const auto &val : dataset)
+                    containerFuncAdd(container, val);
+
+                timeOperations(containerTimeAveraging, dataset.size(),
+                               [&](std::size_t) { containerFuncRemove(container); });
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
+
+    template <typename D>
+    BenchResult benchmarkSuiteRemoveList()
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            auto order = workload.accessOrder(accessPattern, dataset, true);
+
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                List<D> container;
+                std::vector<typename List<D>::Node *> nodes(datasetSize);
+
+                // Prepare container for testing
+                for (std::size_t k = 0; k < datasetSize; k++)
+                    nodes[k] = container.push_back(dataset[k]);
+
+                // Node lookup time isnt taken into account, nodes are already in removal order
+                std::vector<typename List<D>::Node *> removeOrder(datasetSize);
+                for (std::size_t k = 0; k < datasetSize; k++)
+                    removeOrder[k] = nodes[order[k]];
+
+                timeOperations(containerTimeAveraging, removeOrder.size(),
+                               [&](std::size_t k) { container.remove(removeOrder[k]); });
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
+
+    template <template <typename> typename T, typename D>
+    BenchResult benchmarkSuiteSortedAdd(bool useHint)
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            std::sort(dataset.begin(), dataset.end());
+
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                T<D> container;
+                typename T<D>::Node *last = nullptr;
+
+                timeOperations(containerTimeAveraging, dataset.size(), [&](std::size_t k) {
+                    if (useHint)
+                        last = container.insert_hint(last, dataset[k]);
+                    else
+                        container.add(dataset[k]);
+                });
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
+
+    template <template <typename> typename T, typename D, typename PushFunc, typename PopFunc>
+    BenchResult benchmarkSuitePushPop(PushFunc containerFuncPush, PopFunc containerFuncPop)
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset(0, pushPopKeyRange);
+            std::vector<D> increments;
+
+            for (std::size_t i = 0; i < datasetSize; i++)
+                increments.push_back(randomNumberWithinRange((D)0, (D)pushPopIncrementRange));
+
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                auto liveBytesBefore = AllocationCounter::snapshot().liveBytes;
+                T<D> container;
+
+                // Prepare container for testing
+                for (const auto &val : dataset)
+                    containerFuncPush(container, val);
+
+                containerTimeAveraging.addFootprint(AllocationCounter::snapshot().liveBytes - liveBytesBefore,
+                                                    dataset.size());
+
+                // Pop the smallest value and push it back increased by a random amount,
+                // keys stay monotone so every heap type can take part
+                timeOperations(containerTimeAveraging, increments.size(), [&](std::size_t k) {
+                    containerFuncPush(container, containerFuncPop(container) + increments[k]);
+                });
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
+
+    // Contains picks a present key, remove deletes one, add brings a new key from the distribution
+    std::vector<TraceOperation> generateOperations(const std::vector<datatype> &dataset, const OperationMix &mix)
+    {
+        std::vector<datatype> present(dataset);
+        std::vector<datatype> fresh = generateDataset();
+        std::vector<TraceOperation> operations;
+        const unsigned total = mix.contains + mix.add + mix.remove;
+
+        for (std::size_t k = 0; k < datasetSize; k++) {
+            unsigned draw = randomNumberWithinRange(0u, total - 1);
+
+            if (present.empty() || draw >= mix.contains + mix.remove) {
+                operations.push_back({ 'a', fresh[k] });
+                present.push_back(fresh[k]);
+                continue;
+            }
+
+            std::size_t pos = randomNumberWithinRange((std::size_t)0, present.size() - 1);
+
+            if (draw < mix.contains) {
+                operations.push_back({ 'c', present[pos] });
+            }
+            else {
+                operations.push_back({ 'x', present[pos] });
+                present[pos] = present.back();
+                present.pop_back();
+            }
+        }
+
+        return operations;
+    }
+
+    template <template <typename> typename T, typename D, typename AddFunc>
+    void replayOperations(AveragedTimeMeasure &measure, T<D> &container,
+                          const AddFunc &containerFuncAdd,
+                          const std::vector<TraceOperation> &operations)
+    {
+        timeOperations(measure, operations.size(), [&](std::size_t k) {
+            const auto &operation = operations[k];
+
+            switch (operation.type) {
+            case 'a':
+                containerFuncAdd(container, operation.value);
+                break;
+            case 'x':
+                doNotOptimize(container.remove(operation.value));
+                break;
+            case 'c':
+                doNotOptimize(container.contains(operation.value));
+                break;
+            }
+        });
+    }
+
+    template <template <typename> typename T, typename D, typename AddFunc>
+    BenchResult benchmarkSuiteMix(AddFunc containerFuncAdd, const OperationMix &mix)
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            auto operations = generateOperations(dataset, mix);
+
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                T<D> container;
+
+                // Prepare container for testing
+                for (const auto &val : dataset)
+                    containerFuncAdd(container, val);
+
+                replayOperations(containerTimeAveraging, container, containerFuncAdd, operations);
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+
+        BenchResult result = containerTimeAveraging.getResult();
+        result.showThroughput = true;
+        return result;
+    }
+
+    // Replays the trace on an empty container
+    template <template <typename> typename T, typename D, typename AddFunc>
+    BenchResult benchmarkSuiteTrace(AddFunc containerFuncAdd)
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                T<D> container;
+
+                replayOperations(containerTimeAveraging, container, containerFuncAdd, trace);
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+
+        BenchResult result = containerTimeAveraging.getResult();
+        result.showThroughput = true;
+        return result;
+    }
+
+    // Map keys are dataset values printed after a prefix, like YCSB record keys
+    static std::vector<std::string> mapKeys(const std::vector<datatype> &values)
+    {
+        std::vector<std::string> keys;
+        keys.reserve(values.size());
+
+        for (const auto &val : values)
+            keys.push_back("user" + std::to_string(val));
+
+        return keys;
+    }
+
+    // Values are move-only, so map stores them without copies
+    template <template <typename, typename, typename> typename M, typename D>
+    using StringMap = M<std::string, std::unique_ptr<D>, std::less<>>;
+
+    template <template <typename, typename, typename> typename M, typename D>
+    static void fillMap(StringMap<M, D> &map, const std::vector<std::string> &keys, const std::vector<D> &values)
+    {
+        for (std::size_t k = 0; k < keys.size(); k++)
+            map.try_emplace(keys[k], std::make_unique<D>(values[k]));
+    }
+
+    template <template <typename, typename, typename> typename M, typename D>
+    BenchResult benchmarkSuiteMapAdd()
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            auto keys = mapKeys(dataset);
+
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                StringMap<M, D> map;
+
+                timeOperations(containerTimeAveraging, keys.size(), [&](std::size_t k) {
+                    map.try_emplace(keys[k], std::make_unique<D>(dataset[k]));
+                });
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
+
+    // Keys are looked up as string_view, without building a std::string
+    template <template <typename, typename, typename> typename M, typename D>
+    BenchResult benchmarkSuiteMapSearch()
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            StringMap<M, D> map;
+
+            // Prepare container for testing
+            fillMap<M, D>(map, mapKeys(dataset), dataset);
+
+            auto order = accessValues(dataset, false);
+            auto keys = mapKeys(order);
+            std::vector<std::string_view> views(keys.begin(), keys.end());
+
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                timeOperations(containerTimeAveraging, views.size(), [&](std::size_t k) {
+                    const std::unique_ptr<D> *value = map.find(views[k]);
+                    if (!value || **value != order[k])
+                        throw std::runtime_error("nope");
+                });
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
+
+    template <template <typename, typename, typename> typename M, typename D>
+    BenchResult benchmarkSuiteMapSearchMany()
+    {
+        const std::size_t batchSize = 256;
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure(batchSize);
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            StringMap<M, D> map;
+
+            // Prepare container for testing
+            fillMap<M, D>(map, mapKeys(dataset), dataset);
+
+            auto keys = mapKeys(accessValues(dataset, false));
+            std::vector<std::string_view> views(keys.begin(), keys.end());
+            bool results[batchSize];
+
+            // Values past the last full batch are left out
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                timeOperations(containerTimeAveraging, views.size() / batchSize, [&](std::size_t k) {
+                    if (map.contains_many(&views[k * batchSize], batchSize, results) != batchSize)
+                        throw std::runtime_error("nope");
+                });
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
+
+    template <template <typename, typename, typename> typename M, typename D>
+    BenchResult benchmarkSuiteMapRemove()
+    {
+        AveragedTimeMeasure containerTimeAveraging = makeTimeMeasure();
+
+        for (std::size_t j = 0; moreRepetitions(j); j++) {
+            auto dataset = generateDataset();
+            auto datasetKeys = mapKeys(dataset);
+
+            // Map keeps one entry per key, later copies of a key are left out
+            std::vector<datatype> order;
+            std::set<datatype> seen;
+            for (const auto &val : accessValues(dataset, true))
+                if (seen.insert(val).second)
+                    order.push_back(val);
+
+            auto keys = mapKeys(order);
+            std::vector<std::string_view> views(keys.begin(), keys.end());
+
+            for (std::size_t i = 0; i < averagingLoopsCount; i++) {
+                StringMap<M, D> map;
+
+                // Prepare container for testing
+                fillMap<M, D>(map, datasetKeys, dataset);
+
+                timeOperations(containerTimeAveraging, views.size(), [&](std::size_t k) {
+                    if (!map.remove(views[k]))
+                        throw std::runtime_error("nope");
+                });
+            }
+
+            containerTimeAveraging.finishRepetition();
+        }
+        return containerTimeAveraging.getResult();
+    }
+
+    struct BenchCase
+    {
+        std::string container;
+        std::string operation;
+        // Related cases are separated by an empty line in text output
+        std::string group;
+        // Skipped for datasets larger than linearCutoff
+        bool linear;
+        // Operations follow the access pattern, other cases run once per key distribution
+        bool accessed;
+        std::function<BenchResult()> suite;
+    };
+
+    static bool matchesFilter(const std::vector<std::string> &filter, const std::string &name)
+    {
+        if (filter.empty())
+            return true;
+
+        for (const auto &entry : filter)
+            if (equalIgnoreCase(entry, name))
+                return true;
+
+        return false;
+    }
+
+    std::vector<BenchCase> makeCases()
+    {
+        auto array_push_back_lambda =
+            [](Array<datatype> &array, const datatype &val) { array.push_back(val); };
+        auto array_push_front_lambda =
+            [](Array<datatype> &array, const datatype &val) { array.push_front(val); };
+
+        auto list_push_back_lambda =
+            [](List<datatype> &list, const datatype &val) { list.push_back(val); };
+        auto list_push_front_lambda =
+            [](List<datatype> &list, const datatype &val) { list.push_front(val); };
+
+        auto binheap_add_lambda =
+            [](BinHeap<datatype> &binheap, const datatype &val) { binheap.add(val); };
+
+        // BinHeap is a max-heap, negate values to keep the smallest one on top
+        auto binheap_push_lambda =
+            [](BinHeap<datatype> &binheap, const datatype &val) { binheap.add(-val); };
+        auto binheap_pop_lambda =
+            [](BinHeap<datatype> &binheap) { datatype val = -binheap.top(); binheap.pop(); return val; };
+
+        auto pairingheap_push_lambda =
+            [](PairingHeap<datatype> &pairingheap, const datatype &val) { pairingheap.add(val); };
+        auto pairingheap_pop_lambda =
+            [](PairingHeap<datatype> &pairingheap) { datatype val = pairingheap.top(); pairingheap.pop(); return val; };
+
+        auto radixheap_push_lambda =
+            [](RadixHeap<datatype> &radixheap, const datatype &val) { radixheap.add(val); };
+        auto radixheap_pop_lambda =
+            [](RadixHeap<datatype> &radixheap) { datatype val = radixheap.top(); radixheap.pop(); return val; };
+
+        auto rbtree_add_lambda =
+            [](RBTree<datatype> &rbtree, const datatype &val) { rbtree.add(val); };
+
+        auto avltree_add_lambda =
+            [](AVLTree<datatype> &avltree, const datatype &val) { avltree.add(val); };
+
+        auto persistentrbtree_add_lambda =
+            [](PersistentRBTree<datatype> &tree, const datatype &val) { tree.add(val); };
+
+        auto treap_add_lambda =
+            [](Treap<datatype> &treap, const datatype &val) { treap.add(val); };
+
+        // Ranges are given as their sorted values, balanced trees go through all of them
+        auto rbtree_erase_range_lambda =
+            [](RBTree<datatype> &rbtree, const datatype *values, std::size_t count) { rbtree.remove_many(values, count); };
+        auto avltree_erase_range_lambda =
+            [](AVLTree<datatype> &avltree, const datatype *values, std::size_t count) { avltree.remove_many(values, count); };
+        auto treap_erase_range_lambda =
+            [](Treap<datatype> &treap, const datatype *values, std::size_t count) { treap.erase_range(values[0], values[count - 1]); };
+
+        auto rbtree_insert_range_lambda =
+            [](RBTree<datatype> &rbtree, const datatype *values, std::size_t count) { rbtree.add_many(values, count); };
+        auto avltree_insert_range_lambda =
+            [](AVLTree<datatype> &avltree, const datatype *values, std::size_t count) { avltree.add_many(values, count); };
+        auto treap_insert_range_lambda =
+            [](Treap<datatype> &treap, const datatype *values, std::size_t count) { treap.insert_range(values, count); };
+
+        auto array_pop_back_lambda =
+            [](Array<datatype> &array) { array.pop_back(); };
+        auto array_pop_front_lambda =
+            [](Array<datatype> &array) { array.pop_front(); };
+
+        auto list_pop_back_lambda =
+            [](List<datatype> &list) { list.pop_back(); };
+        auto list_pop_front_lambda =
+            [](List<datatype> &list) { list.pop_front(); };
+
+        // Cases are kept after this call returns
+        TimeBenchmark *bench = this;
+
+        std::vector<BenchCase> cases = {
+            // Add
+            { "Array", "push_back", "add", true, false,
+              [=] { return bench->benchmarkSuiteAdd<Array, datatype>(array_push_back_lambda); } },
+            { "Array", "push_front", "add", true, false,
+              [=] { return bench->benchmarkSuiteAdd<Array, datatype>(array_push_front_lambda); } },
+            { "List", "push_back", "add", true, false,
+              [=] { return bench->benchmarkSuiteAdd<List, datatype>(list_push_back_lambda); } },
+            { "List", "push_front", "add", true, false,
+              [=] { return bench->benchmarkSuiteAdd<List, datatype>(list_push_front_lambda); } },
+            { "BinHeap", "add", "add", true, false,
+              [=] { return bench->benchmarkSuiteAdd<BinHeap, datatype>(binheap_add_lambda); } },
+            { "RBTree", "add", "add", false, false,
+              [=] { return bench->benchmarkSuiteAdd<RBTree, datatype>(rbtree_add_lambda); } },
+            { "AVLTree", "add", "add", false, false,
+              [=] { return bench->benchmarkSuiteAdd<AVLTree, datatype>(avltree_add_lambda); } },
+            { "PersistentRBTree", "add", "add", false, false,
+              [=] { return bench->benchmarkSuiteAdd<PersistentRBTree, datatype>(persistentrbtree_add_lambda); } },
+            { "Treap", "add", "add", false, false,
+              [=] { return bench->benchmarkSuiteAdd<Treap, datatype>(treap_add_lambda); } },
+
+            // Sequential keys
+            { "RBTree", "add_sorted", "sorted", false, false,
+              [=] { return bench->benchmarkSuiteSortedAdd<RBTree, datatype>(false); } },
+            { "RBTree", "hint_sorted", "sorted", false, false,
+              [=] { return bench->benchmarkSuiteSortedAdd<RBTree, datatype>(true); } },
+            { "AVLTree", "add_sorted", "sorted", false, false,
+              [=] { return bench->benchmarkSuiteSortedAdd<AVLTree, datatype>(false); } },
+            { "AVLTree", "hint_sorted", "sorted", false, false,
+              [=] { return bench->benchmarkSuiteSortedAdd<AVLTree, datatype>(true); } },
+
+            // Insert
+            { "Array", "insert", "insert", true, false,
+              [=] { return bench->benchmarkSuiteArrayInsert<datatype>(); } },
+            { "List", "insert_ref", "insert", true, false,
+              [=] { return bench->benchmarkSuiteListInsert<datatype>(); } },
+
+            // Contains
+            { "Array", "contains", "contains", true, true,
+              [=] { return bench->benchmarkSuiteSearch<Array, datatype>(array_push_back_lambda); } },
+            { "List", "contains", "contains", true, true,
+              [=] { return bench->benchmarkSuiteSearch<List, datatype>(list_push_back_lambda); } },
+            { "BinHeap", "contains", "contains", true, true,
+              [=] { return bench->benchmarkSuiteSearch<BinHeap, datatype>(binheap_add_lambda); } },
+            { "RBTree", "contains", "contains", false, true,
+              [=] { return bench->benchmarkSuiteSearch<RBTree, datatype>(rbtree_add_lambda); } },
+            { "AVLTree", "contains", "contains", false, true,
+              [=] { return bench->benchmarkSuiteSearch<AVLTree, datatype>(avltree_add_lambda); } },
+            { "PersistentRBTree", "contains", "contains", false, true,
+              [=] { return bench->benchmarkSuiteSearch<PersistentRBTree, datatype>(persistentrbtree_add_lambda); } },
+            { "Treap", "contains", "contains", false, true,
+              [=] { return bench->benchmarkSuiteSearch<Treap, datatype>(treap_add_lambda); } },
+            { "BinHeap", "contains_many", "contains", true, true,
+              [=] { return bench->benchmarkSuiteSearchMany<BinHeap, datatype>(binheap_add_lambda); } },
+            { "RBTree", "contains_many", "contains", false, true,
+              [=] { return bench->benchmarkSuiteSearchMany<RBTree, datatype>(rbtree_add_lambda); } },
+            { "AVLTree", "contains_many", "contains", false, true,
+              [=] { return bench->benchmarkSuiteSearchMany<AVLTree, datatype>(avltree_add_lambda); } },
+
+            // Remove
+            { "Array", "remove", "remove", true, true,
+              [=] { return bench->benchmarkSuiteRemove<Array, datatype>(array_push_back_lambda); } },
+            { "Array", "pop_back", "remove", true, false,
+              [=] { return bench->benchmarkSuiteRemoveFunc<Array, datatype>(array_push_back_lambda, array_pop_back_lambda); } },
+            { "Array", "pop_front", "remove", true, false,
+              [=] { return bench->benchmarkSuiteRemoveFunc<Array, datatype>(array_push_back_lambda, array_pop_front_lambda); } },
+            { "List", "pop_back", "remove", true, false,
+              [=] { return bench->benchmarkSuiteRemoveFunc<List, datatype>(list_push_back_lambda, list_pop_back_lambda); } },
+            { "List", "pop_front", "remove", true, false,
+              [=] { return bench->benchmarkSuiteRemoveFunc<List, datatype>(list_push_back_lambda, list_pop_front_lambda); } },
+            { "List", "remove_val", "remove", true, true,
+              [=] { return bench->benchmarkSuiteRemove<List, datatype>(list_push_back_lambda); } },
+            { "List", "remove_ref", "remove", true, true,
+              [=] { return bench->benchmarkSuiteRemoveList<datatype>(); } },
+            { "BinHeap", "remove", "remove", true, true,
+              [=] { return bench->benchmarkSuiteRemove<BinHeap, datatype>(binheap_add_lambda); } },
+            { "RBTree", "remove", "remove", false, true,
+              [=] { return bench->benchmarkSuiteRemove<RBTree, datatype>(rbtree_add_lambda); } },
+            { "AVLTree", "remove", "remove", false, true,
+              [=] { return bench->benchmarkSuiteRemove<AVLTree, datatype>(avltree_add_lambda); } },
+            { "PersistentRBTree", "remove", "remove", false, true,
+              [=] { return bench->benchmarkSuiteRemove<PersistentRBTree, datatype>(persistentrbtree_add_lambda); } },
+            { "Treap", "remove", "remove", false, true,
+              [=] { return bench->benchmarkSuiteRemove<Treap, datatype>(treap_add_lambda); } },
+
+            // Ranges
+            { "RBTree", "insert_range", "range", false, false,
+              [=] { return bench->benchmarkSuiteRange<RBTree, datatype>(rbtree_add_lambda, rbtree_insert_range_lambda, false); } },
+            { "AVLTree", "insert_range", "range", false, false,
+              [=] { return bench->benchmarkSuiteRange<AVLTree, datatype>(avltree_add_lambda, avltree_insert_range_lambda, false); } },
+            { "Treap", "insert_range", "range", false, false,
+              [=] { return bench->benchmarkSuiteRange<Treap, datatype>(treap_add_lambda, treap_insert_range_lambda, false); } },
+            { "RBTree", "erase_range", "range", false, false,
+              [=] { return bench->benchmarkSuiteRange<RBTree, datatype>(rbtree_add_lambda, rbtree_erase_range_lambda, true); } },
+            { "AVLTree", "erase_range", "range", false, false,
+              [=] { return bench->benchmarkSuiteRange<AVLTree, datatype>(avltree_add_lambda, avltree_erase_range_lambda, true); } },
+            { "Treap", "erase_range", "range", false, false,
+              [=] { return bench->benchmarkSuiteRange<Treap, datatype>(treap_add_lambda, treap_erase_range_lambda, true); } },
+
+            // Maps with string keys
+            { "RBMap", "add", "map", false, false,
+              [=] { return bench->benchmarkSuiteMapAdd<RBMap, datatype>(); } },
+            { "AVLMap", "add", "map", false, false,
+              [=] { return bench->benchmarkSuiteMapAdd<AVLMap, datatype>(); } },
+            { "RBMap", "contains", "map", false, true,
+              [=] { return bench->benchmarkSuiteMapSearch<RBMap, datatype>(); } },
+            { "AVLMap", "contains", "map", false, true,
+              [=] { return bench->benchmarkSuiteMapSearch<AVLMap, datatype>(); } },
+            { "RBMap", "contains_many", "map", false, true,
+              [=] { return bench->benchmarkSuiteMapSearchMany<RBMap, datatype>(); } },
+            { "AVLMap", "contains_many", "map", false, true,
+              [=] { return bench->benchmarkSuiteMapSearchMany<AVLMap, datatype>(); } },
+            { "RBMap", "remove", "map", false, true,
+              [=] { return bench->benchmarkSuiteMapRemove<RBMap, datatype>(); } },
+            { "AVLMap", "remove", "map", false, true,
+              [=] { return bench->benchmarkSuiteMapRemove<AVLMap, datatype>(); } },
+
+            // Push/pop
+            { "BinHeap", "push_pop", "push_pop", true, false,
+              [=] { return bench->benchmarkSuitePushPop<BinHeap, datatype>(binheap_push_lambda, binheap_pop_lambda); } },
+            { "PairingHeap", "push_pop", "push_pop", false, false,
+              [=] { return bench->benchmarkSuitePushPop<PairingHeap, datatype>(pairingheap_push_lambda, pairingheap_pop_lambda); } },
+            { "RadixHeap", "push_pop", "push_pop", false, false,
+              [=] { return bench->benchmarkSuitePushPop<RadixHeap, datatype>(radixheap_push_lambda, radixheap_pop_lambda); } },
+        };
+
+#ifdef INTERLEAVED_LOOKUP
+        // Throughput against the number of lookups in flight
+        for (std::size_t width : { 1, 2, 4, 8, 16, 32 }) {
+            std::string operation = "contains_coro_" + std::to_string(width);
+
+            cases.push_back({ "RBTree", operation, "contains", false, true,
+                              [=] { return bench->benchmarkSuiteSearchInterleaved<RBTree, datatype>(rbtree_add_lambda, width); } });
+            cases.push_back({ "AVLTree", operation, "contains", false, true,
+                              [=] { return bench->benchmarkSuiteSearchInterleaved<AVLTree, datatype>(avltree_add_lambda, width); } });
+
+            operation = "lower_bound_coro_" + std::to_string(width);
+            cases.push_back({ "RBTree", operation, "contains", false, true,
+                              [=] { return bench->benchmarkSuiteLowerBoundInterleaved<RBTree, datatype>(rbtree_add_lambda, width); } });
+            cases.push_back({ "AVLTree", operation, "contains", false, true,
+                              [=] { return bench->benchmarkSuiteLowerBoundInterleaved<AVLTree, datatype>(avltree_add_lambda, width); } });
+
+            operation = "count_range_coro_" + std::to_string(width);
+            cases.push_back({ "RBTree", operation, "contains", false, true,
+                              [=] { return bench->benchmarkSuiteCountRangeInterleaved<RBTree, datatype>(rbtree_add_lambda, width); } });
+            cases.push_back({ "AVLTree", operation, "contains", false, true,
+                              [=] { return bench->benchmarkSuiteCountRangeInterleaved<AVLTree, datatype>(avltree_add_lambda, width); } });
+        }
+#endif // INTERLEAVED_LOOKUP
+
+        // Mixed contains/add/remove
+        for (const auto &mix : operationMixes) {
+            cases.push_back({ "Array", mix.name(), "mix", true, false,
+                              [=] { return bench->benchmarkSuiteMix<Array, datatype>(array_push_back_lambda, mix); } });
+            cases.push_back({ "List", mix.name(), "mix", true, false,
+                              [=] { return bench->benchmarkSuiteMix<List, datatype>(list_push_back_lambda, mix); } });
+            cases.push_back({ "BinHeap", mix.name(), "mix", true, false,
+                              [=] { return bench->benchmarkSuiteMix<BinHeap, datatype>(binheap_add_lambda, mix); } });
+            cases.push_back({ "RBTree", mix.name(), "mix", false, false,
+                              [=] { return bench->benchmarkSuiteMix<RBTree, datatype>(rbtree_add_lambda, mix); } });
+            cases.push_back({ "AVLTree", mix.name(), "mix", false, false,
+                              [=] { return bench->benchmarkSuiteMix<AVLTree, datatype>(avltree_add_lambda, mix); } });
+        }
+
+        return cases;
+    }
+
+    std::vector<BenchCase> makeTraceCases()
+    {
+        TimeBenchmark *bench = this;
+
+        auto array_push_back_lambda =
+            [](Array<datatype> &array, const datatype &val) { array.push_back(val); };
+        auto list_push_back_lambda =
+            [](List<datatype> &list, const datatype &val) { list.push_back(val); };
+        auto binheap_add_lambda =
+            [](BinHeap<datatype> &binheap, const datatype &val) { binheap.add(val); };
+        auto rbtree_add_lambda =
+            [](RBTree<datatype> &rbtree, const datatype &val) { rbtree.add(val); };
+        auto avltree_add_lambda =
+            [](AVLTree<datatype> &avltree, const datatype &val) { avltree.add(val); };
+
+        return {
+            { "Array", "trace", "trace", true, false,
+              [=] { return bench->benchmarkSuiteTrace<Array, datatype>(array_push_back_lambda); } },
+            { "List", "trace", "trace", true, false,
+              [=] { return bench->benchmarkSuiteTrace<List, datatype>(list_push_back_lambda); } },
+            { "BinHeap", "trace", "trace", true, false,
+              [=] { return bench->benchmarkSuiteTrace<BinHeap, datatype>(binheap_add_lambda); } },
+            { "RBTree", "trace", "trace", false, false,
+              [=] { return bench->benchmarkSuiteTrace<RBTree, datatype>(rbtree_add_lambda); } },
+            { "AVLTree", "trace", "trace", false, false,
+              [=] { return bench->benchmarkSuiteTrace<AVLTree, datatype>(avltree_add_lambda); } },
+        };
+    }
+
+    // One case for one workload and dataset size, indices into the lists being tested
+    struct BenchTask
+    {
+        std::size_t distribution;
+        std::size_t pattern;
+        std::size_t size;
+        std::size_t benchCase;
+    };
+
+    std::vector<BenchTask> makeTasks(const std::vector<BenchCase> &cases) const
+    {
+        std::vector<BenchTask> tasks;
+
+        for (std::size_t distribution = 0; distribution < keyDistributionsToTest.size(); distribution++) {
+            for (std::size_t pattern = 0; pattern < accessPatternsToTest.size(); pattern++) {
+                for (std::size_t size = 0; size < datasetSizesToTest.size(); size++) {
+                    for (std::size_t i = 0; i < cases.size(); i++) {
+                        const auto &benchCase = cases[i];
+
+                        if (!matchesFilter(containerFilter, benchCase.container) ||
+                            !matchesFilter(operationFilter, benchCase.operation))
+                            continue;
+
+                        if (benchCase.linear && datasetSizesToTest[size] > linearCutoff)
+                            continue;
+
+                        // Pattern does not change these cases, run them with the first one only
+                        if (!benchCase.accessed && pattern != 0)
+                            continue;
+
+                        tasks.push_back({ distribution, pattern, size, i });
+                    }
+                }
+            }
+        }
+
+        return tasks;
+    }
+
+    // Every task is seeded on its own, results do not depend on order or number of threads
+    BenchResult runTask(const std::vector<BenchCase> &cases, const BenchTask &task)
+    {
+        keyDistribution = keyDistributionsToTest[task.distribution];
+        accessPattern = accessPatternsToTest[task.pattern];
+        datasetSize = datasetSizesToTest[task.size];
+
+        std::seed_seq seed = { generatorSeed, (unsigned)task.distribution, (unsigned)task.pattern,
+                               (unsigned)task.size, (unsigned)task.benchCase };
+        workload.engine().seed(seed);
+
+        return runSuite(cases[task.benchCase].suite);
+    }
+
+    std::vector<int> runnerCpus() const
+    {
+        if (!cpusToUse.empty())
+            return cpusToUse;
+
+        // Hardware threads of one core share its caches and execution units
+        std::vector<int> cores = CpuAffinity::withoutSmtSiblings(CpuAffinity::allowed());
+
+        // CPU 0 handles most interrupts, leave it free when other cores are enough
+        if (jobsCount != 0 && cores.size() > jobsCount && cores.front() == 0)
+            cores.erase(cores.begin());
+
+        return cores;
+    }
+
+    // Runs tasks on worker threads, each with its own copy of the benchmark pinned to its own CPU
+    std::vector<BenchResult> runTasksParallel(const std::vector<BenchTask> &tasks, std::size_t jobs,
+                                              const std::vector<int> &cpus)
+    {
+        std::vector<BenchResult> results(tasks.size());
+
+        // Largest datasets go first so no long task is left for the end
+        std::vector<std::size_t> order(tasks.size());
+        for (std::size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t first, std::size_t second) {
+            return datasetSizesToTest[tasks[first].size] > datasetSizesToTest[tasks[second].size];
+        });
+
+        std::atomic<std::size_t> next(0);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        std::vector<std::thread> threads;
+
+        for (std::size_t job = 0; job < jobs; job++) {
+            threads.emplace_back([&, job] {
+                try {
+                    if (!cpus.empty() && !CpuAffinity::pinCurrentThread(cpus[job]))
+                        throw std::runtime_error("Cannot pin benchmark thread to CPU " +
+                                                 std::to_string(cpus[job]) + "!");
+
+                    TimeBenchmark worker(*this);
+                    // Baseline of the core the worker runs on
+                    worker.calibrateBaseline();
+                    auto cases = worker.makeCases();
+
+                    for (std::size_t i = next++; i < order.size(); i = next++)
+                        results[order[i]] = worker.runTask(cases, tasks[order[i]]);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                    next = order.size();
+                }
+            });
+        }
+
+        for (auto &thread : threads)
+            thread.join();
+
+        if (error)
+            std::rethrow_exception(error);
+
+        return results;
+    }
+
+    void finishDatasetSize()
+    {
+        textStream() << "\\\\\\\\\\\\\\\\\\\\\\\\\\\n" << endl;
+    }
+
+    // Prints headers when the task starts a new workload, dataset size or group of cases
+    void reportTask(const std::vector<BenchCase> &cases, const std::vector<BenchTask> &tasks, std::size_t index,
+                    const BenchResult &result)
+    {
+        std::ostream &text = textStream();
+        const BenchTask &task = tasks[index];
+        const BenchTask *previous = index ? &tasks[index - 1] : nullptr;
+
+        keyDistribution = keyDistributionsToTest[task.distribution];
+        accessPattern = accessPatternsToTest[task.pattern];
+        datasetSize = datasetSizesToTest[task.size];
+
+        bool newWorkload = !previous || previous->distribution != task.distribution ||
+            previous->pattern != task.pattern;
+        bool newSize = newWorkload || previous->size != task.size;
+
+        if (previous && newSize)
+            finishDatasetSize();
+
+        if (newWorkload)
+            text << "Keys: " << workloadName(keyDistribution) << ", access: " << workloadName(accessPattern) << "\n\n";
+
+        if (newSize)
+            text << "Testing dataset at size: " << datasetSize << "\n//////////////\n";
+        else if (cases[previous->benchCase].group != cases[task.benchCase].group)
+            text << endl;
+
+        report(cases[task.benchCase], result);
+    }
+
+    static std::string buildInfo()
+    {
+        std::string info;
+
+#if defined(__clang__)
+        info = "clang " __clang_version__;
+#elif defined(__GNUC__)
+        info = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        info = "msvc " + std::to_string(_MSC_VER);
+#else
+        info = "unknown";
+#endif
+
+        // Exact flags are not visible to the code, report what they changed
+#ifdef __OPTIMIZE__
+        info += " optimized";
+#endif
+#ifdef NDEBUG
+        info += " NDEBUG";
+#endif
+#ifdef __AVX2__
+        info += " AVX2";
+#endif
+        info += " C++" + std::to_string(__cplusplus);
+
+        return info;
+    }
+
+    const char *timingModeName() const
+    {
+        return timingMode == TimingMode::BATCH ? "batch" : "per_operation";
+    }
+
+    const char *clockSourceName() const
+    {
+        return clockSource == ClockSource::TSC ? "tsc" : "chrono";
+    }
+
+    // Human readable progress, kept off stdout when results are written there
+    std::ostream &textStream() const
+    {
+        if (outputFormat == OutputFormat::TEXT || !outputPath.empty())
+            return std::cout;
+
+        return std::cerr;
+    }
+
+    static std::string escapeCsv(const std::string &value)
+    {
+        std::string escaped = "\"";
+
+        for (auto c : value) {
+            if (c == '"')
+                escaped += '"';
+            escaped += c;
+        }
+
+        return escaped + '"';
+    }
+
+    static std::string escapeJson(const std::string &value)
+    {
+        std::string escaped = "\"";
+
+        for (auto c : value) {
+            if (c == '"' || c == '\\')
+                escaped += '\\';
+            escaped += c;
+        }
+
+        return escaped + '"';
+    }
+
+    static std::vector<std::string> splitCsvLine(const std::string &line)
+    {
+        std::vector<std::string> fields(1);
+        bool quoted = false;
+
+        for (std::size_t i = 0; i < line.size(); i++) {
+            char c = line[i];
+
+            if (quoted) {
+                if (c == '"' && i + 1 < line.size() && line[i + 1] == '"')
+                    fields.back() += line[++i];
+                else if (c == '"')
+                    quoted = false;
+                else
+                    fields.back() += c;
+            }
+            else if (c == '"')
+                quoted = true;
+            else if (c == ',')
+                fields.emplace_back();
+            else if (c != '\r')
+                fields.back() += c;
+        }
+
+        return fields;
+    }
+
+    void report(const std::string &container, const std::string &operation, const std::string &keys,
+                const std::string &access, const BenchResult &result)
+    {
+        reportRows.push_back({ container, operation, keys, access, datasetSize, result });
+
+        textStream() << std::left << std::setw(28) << (container + " " + operation + ":")
+            << std::right << result << "\n";
+    }
+
+    void report(const BenchCase &benchCase, const BenchResult &result)
+    {
+        report(benchCase.container, benchCase.operation, workloadName(keyDistribution),
+               benchCase.accessed ? workloadName(accessPattern) : "-", result);
+    }
+
+    void writeCsv(std::ostream &stream) const
+    {
+        stream << "container,operation,keys,access,size,mean_ns,stddev_ns,p50_ns,p99_ns,p999_ns,max_ns,"
+            << "ops_per_sec,";
+
+        for (int event = 0; event < PerfCounters::EVENTS_COUNT; event++)
+            stream << PerfCounters::name((PerfCounters::Event)event) << ',';
+
+        stream << "allocs_per_op,alloc_bytes_per_op,bytes_per_element,"
+            << "operations,repetitions,timing,clock,seed,build\n";
+
+        for (const auto &row : reportRows) {
+            const auto &result = row.result;
+
+            stream << row.container << ',' << row.operation << ',' << row.keys << ',' << row.access << ','
+                << row.datasetSize << ','
+                << result.mean << ',' << result.stddev << ',';
+
+            if (result.hasPercentiles)
+                stream << result.p50 << ',' << result.p99 << ',' << result.p999 << ',' << result.max << ',';
+            else
+                stream << ",,,,";
+
+            stream << (unsigned long long)result.throughput << ',';
+
+            for (int event = 0; event < PerfCounters::EVENTS_COUNT; event++) {
+                if (result.hasCounter[event])
+                    stream << result.counters[event];
+                stream << ',';
+            }
+
+            stream << result.allocationsPerOp << ',' << result.allocatedBytesPerOp << ',';
+            if (result.bytesPerElement)
+                stream << result.bytesPerElement;
+            stream << ',';
+
+            stream << result.operations << ',' << result.repetitions << ',' << timingModeName() << ','
+                << clockSourceName() << ',' << generatorSeed << ',' << escapeCsv(buildInfo()) << '\n';
+        }
+    }
+
+    void writeJson(std::ostream &stream) const
+    {
+        stream << "{\n  \"timing\": \"" << timingModeName() << "\",\n  \"clock\": \"" << clockSourceName()
+            << "\",\n  \"seed\": " << generatorSeed << ",\n  \"build\": " << escapeJson(buildInfo())
+            << ",\n  \"peak_rss_kb\": " << AllocationCounter::peakResidentBytes() / 1024
+            << ",\n  \"results\": [";
+
+        for (std::size_t i = 0; i < reportRows.size(); i++) {
+            const auto &row = reportRows[i];
+            const auto &result = row.result;
+
+            stream << (i ? ",\n" : "\n") << "    { \"container\": " << escapeJson(row.container)
+                << ", \"operation\": " << escapeJson(row.operation) << ", \"keys\": " << escapeJson(row.keys)
+                << ", \"access\": " << escapeJson(row.access) << ", \"size\": " << row.datasetSize
+                << ", \"mean_ns\": " << result.mean << ", \"stddev_ns\": " << result.stddev;
+
+            if (result.hasPercentiles)
+                stream << ", \"p50_ns\": " << result.p50 << ", \"p99_ns\": " << result.p99
+                    << ", \"p999_ns\": " << result.p999 << ", \"max_ns\": " << result.max;
+
+            stream << ", \"ops_per_sec\": " << (unsigned long long)result.throughput;
+
+            for (int event = 0; event < PerfCounters::EVENTS_COUNT; event++)
+                if (result.hasCounter[event])
+                    stream << ", \"" << PerfCounters::name((PerfCounters::Event)event) << "\": "
+                        << result.counters[event];
+
+            stream << ", \"allocs_per_op\": " << result.allocationsPerOp
+                << ", \"alloc_bytes_per_op\": " << result.allocatedBytesPerOp;
+            if (result.bytesPerElement)
+                stream << ", \"bytes_per_element\": " << result.bytesPerElement;
+
+            stream << ", \"operations\": " << result.operations
+                << ", \"repetitions\": " << result.repetitions << " }";
+        }
+
+        stream << "\n  ]\n}\n";
+    }
+
+    void writeResults() const
+    {
+        if (outputFormat == OutputFormat::TEXT)
+            return;
+
+        std::ofstream file;
+        if (!outputPath.empty()) {
+            file.open(outputPath);
+            if (!file.is_open())
+                throw std::runtime_error("Cannot open results file!");
+        }
+
+        std::ostream &stream = outputPath.empty() ? std::cout : file;
+
+        if (outputFormat == OutputFormat::CSV)
+            writeCsv(stream);
+        else
+            writeJson(stream);
+    }
+
+    // Two-sided 95% critical value of Student's t distribution
+    static double tCriticalValue(double degreesOfFreedom)
+    {
+        static const double table[] = {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+        };
+
+        if (degreesOfFreedom < 1)
+            return table[0];
+        if (degreesOfFreedom <= 30)
+            return table[(std::size_t)degreesOfFreedom - 1];
+        if (degreesOfFreedom <= 40)
+            return 2.021;
+        if (degreesOfFreedom <= 60)
+            return 2.000;
+        if (degreesOfFreedom <= 120)
+            return 1.980;
+
+        return 1.960;
+    }
+
+    // Welch's t-test on per-repetition means
+    static bool significantDifference(double mean1, double stddev1, std::size_t count1,
+                                      double mean2, double stddev2, std::size_t count2)
+    {
+        if (count1 < 2 || count2 < 2)
+            return false;
+
+        double variance1 = stddev1 * stddev1 / count1;
+        double variance2 = stddev2 * stddev2 / count2;
+        double standardError = std::sqrt(variance1 + variance2);
+
+        if (standardError == 0)
+            return mean1 != mean2;
+
+        double t = (mean1 - mean2) / standardError;
+        double degreesOfFreedom = (variance1 + variance2) * (variance1 + variance2) /
+            (variance1 * variance1 / (count1 - 1) + variance2 * variance2 / (count2 - 1));
+
+        return std::fabs(t) > tCriticalValue(degreesOfFreedom);
+    }
+
+    // Returns number of rows that got significantly slower
+    std::size_t compareWithBaseline() const
+    {
+        if (comparePath.empty())
+            return 0;
+
+        std::ifstream file(comparePath);
+        if (!file.is_open())
+            throw std::runtime_error("Cannot open baseline file!");
+
+        std::string line;
+        std::getline(file, line);
+        auto header = splitCsvLine(line);
+
+        std::map<std::string, std::size_t> columns;
+        for (std::size_t i = 0; i < header.size(); i++)
+            columns[header[i]] = i;
+
+        for (auto name : { "container", "operation", "keys", "access", "size", "mean_ns", "stddev_ns", "repetitions" })
+            if (columns.find(name) == columns.end())
+                throw std::runtime_error("Baseline file is not a CSV result file!");
+
+        struct BaselineRow
+        {
+            double mean;
+            double stddev;
+            std::size_t repetitions;
+        };
+        std::map<std::string, BaselineRow> baseline;
+
+        while (std::getline(file, line)) {
+            auto fields = splitCsvLine(line);
+            if (fields.size() < header.size())
+                continue;
+
+            std::string key = fields[columns["container"]] + ' ' + fields[columns["operation"]] + ' ' +
+                fields[columns["keys"]] + ' ' + fields[columns["access"]] + ' ' + fields[columns["size"]];
+            baseline[key] = { std::stod(fields[columns["mean_ns"]]), std::stod(fields[columns["stddev_ns"]]),
+                              std::stoul(fields[columns["repetitions"]]) };
+        }
+
+        std::ostream &stream = textStream();
+        std::size_t regressions = 0;
+
+        stream << "Comparison with " << comparePath << ":\n";
+
+        for (const auto &row : reportRows) {
+            std::string key = row.container + ' ' + row.operation + ' ' + row.keys + ' ' + row.access + ' ' +
+                std::to_string(row.datasetSize);
+            auto found = baseline.find(key);
+            if (found == baseline.end())
+                continue;
+
+            const auto &before = found->second;
+            const auto &after = row.result;
+            double change = before.mean ? (after.mean - before.mean) / before.mean : 0;
+
+            const char *verdict = "same";
+            if (std::fabs(change) >= compareRelativeThreshold &&
+                significantDifference(before.mean, before.stddev, before.repetitions,
+                                      after.mean, after.stddev, after.repetitions)) {
+                verdict = change > 0 ? "REGRESSION" : "improvement";
+                if (change > 0)
+                    regressions++;
+            }
+
+            stream << std::left << std::setw(48) << (key + ":") << std::right << before.mean << "ns -> "
+                << after.mean << "ns (" << std::showpos << std::fixed << std::setprecision(1) << change * 100
+                << std::noshowpos << std::defaultfloat << std::setprecision(6) << "%) " << verdict << "\n";
+        }
+
+        stream << regressions << " regressions\n";
+
+        return regressions;
+    }
+
+public:
+    TimeBenchmark(TimingMode timingMode = TimingMode::PER_OPERATION,
+                  ClockSource clockSource = ClockSource::CHRONO) :
+        generatorSeed(std::random_device()()), workload(generatorSeed),
+        timingMode(timingMode), clockSource(clockSource)
+    {
+    }
+
+    void setWorkloads(const std::vector<KeyDistribution> &distributions,
+                      const std::vector<AccessPattern> &patterns)
+    {
+        if (distributions.empty() || patterns.empty())
+            throw std::runtime_error("Workload list is empty!");
+
+        keyDistributionsToTest = distributions;
+        accessPatternsToTest = patterns;
+    }
+
+    void setOperationMixes(const std::vector<OperationMix> &mixes)
+    {
+        operationMixes = mixes;
+    }
+
+    // Trace has one operation per line, e.g. "a 15", "x 15" or "c 15"
+    void setTrace(const std::string &path)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+            throw std::runtime_error("Cannot open trace file!");
+
+        std::vector<TraceOperation> operations;
+        TraceOperation operation;
+
+        while (file >> operation.type >> operation.value) {
+            if (operation.type != 'a' && operation.type != 'x' && operation.type != 'c')
+                throw std::runtime_error("Invalid trace operation!");
+
+            operations.push_back(operation);
+        }
+
+        if (!file.eof())
+            throw std::runtime_error("Invalid trace value!");
+
+        tracePath = path;
+        trace = std::move(operations);
+    }
+
+    // Count hardware events per operation, unavailable events are left out of results
+    void setPerfCounters(bool enabled)
+    {
+        countersEnabled = enabled;
+    }
+
+    // Count heap allocations and container footprint, counting runs inside timed operations
+    void setAllocationCounting(bool enabled)
+    {
+        if (enabled && !AllocationCounter::enable())
+            std::cerr << "Warning: allocation counting is not supported on this platform\n";
+    }
+
+    void setSeed(unsigned seed)
+    {
+        generatorSeed = seed;
+        workload.engine().seed(seed);
+    }
+
+    // Suites run in parallel on jobs threads, 0 starts one thread per selected CPU
+    void setJobs(std::size_t jobs)
+    {
+        jobsCount = jobs;
+    }
+
+    // Pin threads to these CPUs instead of automatically chosen physical cores
+    void setCpus(const std::vector<int> &cpus)
+    {
+        cpusToUse = cpus;
+    }
+
+    void setDatasetSizes(const std::vector<std::size_t> &sizes)
+    {
+        datasetSizesToTest = sizes;
+    }
+
+    // Datasets generated per suite and measurement loops over each of them
+    void setRepetitions(std::size_t datasetCount, std::size_t loopsPerDataset)
+    {
+        if (datasetCount == 0 || loopsPerDataset == 0)
+            throw std::runtime_error("Repetition count must be positive!");
+
+        datasetGenerationCount = datasetCount;
+        averagingLoopsCount = loopsPerDataset;
+    }
+
+    void setTimeBudget(std::size_t msecPerSuite)
+    {
+        timeBudgetMsec = msecPerSuite;
+    }
+
+    void setLinearCutoff(std::size_t size)
+    {
+        linearCutoff = size;
+    }
+
+    // Names are matched case insensitively, empty list selects everything
+    void setFilter(const std::vector<std::string> &containers, const std::vector<std::string> &operations)
+    {
+        containerFilter = containers;
+        operationFilter = operations;
+    }
+
+    void setOutput(OutputFormat format, const std::string &path = "")
+    {
+        outputFormat = format;
+        outputPath = path;
+    }
+
+    // Previous CSV results, rows that changed significantly are reported after the run
+    void setCompareBaseline(const std::string &path)
+    {
+        comparePath = path;
+    }
+
+    void runTrace()
+    {
+        std::ostream &text = textStream();
+        text << "Trace: " << tracePath << ", " << trace.size() << " operations\n//////////////\n";
+
+        // Rows are reported with trace length as their size
+        datasetSize = trace.size();
+
+        for (const auto &benchCase : makeTraceCases()) {
+            if (!matchesFilter(containerFilter, benchCase.container) ||
+                !matchesFilter(operationFilter, benchCase.operation))
+                continue;
+
+            report(benchCase.container, benchCase.operation, "trace", "-", runSuite(benchCase.suite));
+        }
+
+        text << "\\\\\\\\\\\\\\\\\\\\\\\\\\\n" << endl;
+    }
+
+    // Returns number of significant regressions against the compare baseline
+    std::size_t run()
+    {
+        auto cases = makeCases();
+
+        calibrateBaseline();
+        reportRows.clear();
+
+        std::ostream &text = textStream();
+        text << "Timing " << (timingMode == TimingMode::BATCH ? "batches" : "single operations")
+            << " with " << (clockSource == ClockSource::TSC ? "TSC" : "chrono") << " clock, baseline: "
+            << baselineNsec << "ns, seed: " << generatorSeed << "\n";
+
+        std::vector<int> cpus = runnerCpus();
+        std::size_t jobs = jobsCount ? jobsCount : std::max<std::size_t>(cpus.size(), 1);
+
+        if (!cpus.empty() && jobs > cpus.size()) {
+            text << "Warning: only " << cpus.size() << " CPUs selected, running " << cpus.size()
+                << " jobs instead of " << jobs << "\n";
+            jobs = cpus.size();
+        }
+        else if (cpus.size() > jobs)
+            cpus.resize(jobs);
+
+        if (jobs > 1 || !cpusToUse.empty()) {
+            text << "Running " << jobs << " jobs on CPUs:";
+            for (int cpu : cpus)
+                text << " " << cpu;
+            if (cpus.empty())
+                text << " unpinned";
+            text << "\n";
+            if (jobs > 1)
+                text << "Parallel suites still share caches and memory bandwidth, compare results of equal job counts\n";
+        }
+
+        double harnessOverhead = measureHarnessOverhead();
+        text << "Harness overhead: " << harnessOverhead << "ns per operation\n";
+        if (harnessOverhead > harnessOverheadLimitNsec)
+            text << "Warning: harness overhead above " << harnessOverheadLimitNsec
+                << "ns, fastest operations are not measured reliably\n";
+
+        if (countersEnabled) {
+            PerfCounters counters;
+
+            if (counters.available())
+                text << "Hardware events are counted around whole timed loops, "
+                    << "events of an empty timed operation are subtracted\n";
+            else
+                text << "Hardware events unavailable: " << counters.error() << "\n";
+        }
+
+        text << "\n";
+
+        auto tasks = makeTasks(cases);
+
+        if (jobs > 1 || !cpusToUse.empty()) {
+            auto results = runTasksParallel(tasks, jobs, cpus);
+
+            for (std::size_t i = 0; i < tasks.size(); i++)
+                reportTask(cases, tasks, i, results[i]);
+        }
+        else {
+            for (std::size_t i = 0; i < tasks.size(); i++)
+                reportTask(cases, tasks, i, runTask(cases, tasks[i]));
+        }
+
+        if (!tasks.empty())
+            finishDatasetSize();
+
+        if (!trace.empty())
+            runTrace();
+
+        // Peak of the whole process, every suite and worker thread included
+        text << "Peak RSS of the run: " << AllocationCounter::peakResidentBytes() / 1024 << "KB\n";
+
+        writeResults();
+
+        return compareWithBaseline();
     }
 };
\ No newline at end of file
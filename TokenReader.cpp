@@ -0,0 +1,65 @@
+#include "TokenReader.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+static bool isTokenSeparator(char character)
+{
+    return character == ' ' || character == '\n' || character == '\r' || character == '\t';
+}
+
+TokenReader::TokenReader(const std::string &path, std::size_t bufferSize) :
+    file(path, std::ios::binary), buffer(bufferSize)
+{
+    if (!file.is_open())
+        throw std::runtime_error("Cannot open file " + path + "!");
+}
+
+void TokenReader::refill()
+{
+    std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+    end -= begin;
+    begin = 0;
+
+    file.read(buffer.data() + end, buffer.size() - end);
+    std::size_t count = file.gcount();
+
+    end += count;
+    bytesRead += count;
+
+    if (count == 0 || !file)
+        endOfFile = true;
+}
+
+bool TokenReader::next(const char *&first, const char *&last)
+{
+    while (true) {
+        while (begin != end && isTokenSeparator(buffer[begin]))
+            begin++;
+
+        std::size_t position = begin;
+        while (position != end && !isTokenSeparator(buffer[position]))
+            position++;
+
+        // Token is complete when a separator or the end of file follows it
+        if (position != end || (endOfFile && position != begin)) {
+            first = buffer.data() + begin;
+            last = buffer.data() + position;
+            begin = position;
+            return true;
+        }
+
+        if (endOfFile)
+            return false;
+
+        if (begin == 0 && end == buffer.size())
+            throw std::runtime_error("Token longer than read buffer!");
+
+        refill();
+    }
+}
+
+std::size_t TokenReader::bytes() const
+{
+    return bytesRead;
+}
\ No newline at end of file
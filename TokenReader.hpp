@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Reads whitespace separated tokens from a file through a fixed size buffer,
+// memory use does not depend on the file size
+class TokenReader
+{
+    std::ifstream file;
+    std::vector<char> buffer;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    std::size_t bytesRead = 0;
+    bool endOfFile = false;
+
+    // Moves unparsed bytes to the front and appends the next chunk of the file
+    void refill();
+
+public:
+    // Throws std::runtime_error when the file cannot be opened
+    TokenReader(const std::string &path, std::size_t bufferSize = 1 << 20);
+
+    // Next token as [first, last), returns false at the end of file.
+    // Pointers stay valid until the next call, tokens longer than the buffer throw
+    bool next(const char *&first, const char *&last);
+
+    std::size_t bytes() const;
+};
\ No newline at end of file
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+#include "Treap.hpp"
+
+template <typename T, typename Compare>
+Treap<T, Compare>::Treap(const Compare &comp) : comp(comp)
+{
+}
+
+template <typename T, typename Compare>
+Treap<T, Compare>::~Treap()
+{
+    delete_subtree(root);
+}
+
+template <typename T, typename Compare>
+std::size_t Treap<T, Compare>::delete_subtree(Node *node)
+{
+    if (!node)
+        return 0;
+
+    // Avoid recursion, each node is deleted once its children are queued
+    std::vector<Node *> nodes{ node };
+    std::size_t deleted = 0;
+
+    while (!nodes.empty()) {
+        node = nodes.back();
+        nodes.pop_back();
+
+        if (node->lchild)
+            nodes.push_back(node->lchild);
+        if (node->rchild)
+            nodes.push_back(node->rchild);
+
+        delete node;
+        deleted++;
+    }
+
+    return deleted;
+}
+
+template <typename T, typename Compare>
+void Treap<T, Compare>::split_before(Node *node, const T &key, Node *&left, Node *&right) const
+{
+    // Links where the next node of each part is attached
+    Node **left_link = &left;
+    Node **right_link = &right;
+
+    while (node) {
+        if (comp(node->value, key)) {
+            *left_link = node;
+            left_link = &node->rchild;
+            node = node->rchild;
+        }
+        else {
+            *right_link = node;
+            right_link = &node->lchild;
+            node = node->lchild;
+        }
+    }
+
+    *left_link = nullptr;
+    *right_link = nullptr;
+}
+
+template <typename T, typename Compare>
+void Treap<T, Compare>::split_after(Node *node, const T &key, Node *&left, Node *&right) const
+{
+    Node **left_link = &left;
+    Node **right_link = &right;
+
+    while (node) {
+        if (!comp(key, node->value)) {
+            *left_link = node;
+            left_link = &node->rchild;
+            node = node->rchild;
+        }
+        else {
+            *right_link = node;
+            right_link = &node->lchild;
+            node = node->lchild;
+        }
+    }
+
+    *left_link = nullptr;
+    *right_link = nullptr;
+}
+
+template <typename T, typename Compare>
+auto Treap<T, Compare>::merge(Node *left, Node *right) -> Node *
+{
+    Node *result;
+    Node **link = &result;
+
+    // Walk down the right spine of left and the left spine of right
+    while (left && right) {
+        if (left->priority >= right->priority) {
+            *link = left;
+            link = &left->rchild;
+            left = left->rchild;
+        }
+        else {
+            *link = right;
+            link = &right->lchild;
+            right = right->lchild;
+        }
+    }
+
+    *link = left ? left : right;
+
+    return result;
+}
+
+template <typename T, typename Compare>
+auto Treap<T, Compare>::unite(Node *first, Node *second) const -> Node *
+{
+    if (!first)
+        return second;
+    if (!second)
+        return first;
+
+    if (first->priority < second->priority)
+        std::swap(first, second);
+
+    // Root with the highest priority stays, the other treap is split around it
+    Node *left, *right;
+    split_before(second, first->value, left, right);
+
+    first->lchild = unite(first->lchild, left);
+    first->rchild = unite(first->rchild, right);
+
+    return first;
+}
+
+template <typename T, typename Compare>
+auto Treap<T, Compare>::build(Node **nodes, std::size_t count) -> Node *
+{
+    // Right spine of the treap built so far, new node is always the rightmost one
+    std::vector<Node *> spine;
+
+    for (std::size_t i = 0; i < count; i++) {
+        Node *node = nodes[i];
+        Node *last = nullptr;
+
+        while (!spine.empty() && spine.back()->priority < node->priority) {
+            last = spine.back();
+            spine.pop_back();
+        }
+
+        node->lchild = last;
+        if (!spine.empty())
+            spine.back()->rchild = node;
+
+        spine.push_back(node);
+    }
+
+    return spine.empty() ? nullptr : spine.front();
+}
+
+template <typename T, typename Compare>
+auto Treap<T, Compare>::add(const T &value) -> Node *
+{
+    Node *node = new Node(value, engine());
+
+    // Node goes where its priority fits, the subtree there is split around its value
+    Node **link = &root;
+    while (*link && (*link)->priority >= node->priority)
+        link = comp(value, (*link)->value) ? &(*link)->lchild : &(*link)->rchild;
+
+    split_before(*link, value, node->lchild, node->rchild);
+    *link = node;
+    count++;
+
+#ifndef NDEBUG
+    check();
+#endif // !NDEBUG
+
+    return node;
+}
+
+template <typename T, typename Compare>
+bool Treap<T, Compare>::remove(const T &value)
+{
+    Node **link = &root;
+
+    while (*link) {
+        if (comp(value, (*link)->value))
+            link = &(*link)->lchild;
+        else if (comp((*link)->value, value))
+            link = &(*link)->rchild;
+        else
+            break;
+    }
+
+    Node *node = *link;
+    if (!node)
+        return false;
+
+    *link = merge(node->lchild, node->rchild);
+    delete node;
+    count--;
+
+#ifndef NDEBUG
+    check();
+#endif // !NDEBUG
+
+    return true;
+}
+
+template <typename T, typename Compare>
+bool Treap<T, Compare>::contains(const T &value) const
+{
+    // Binary search
+    const Node *search = root;
+    while (search) {
+        if (comp(value, search->value))
+            search = search->lchild;
+        else if (comp(search->value, value))
+            search = search->rchild;
+        else
+            return true;
+    }
+
+    return false;
+}
+
+template <typename T, typename Compare>
+std::size_t Treap<T, Compare>::erase_range(const T &low, const T &high)
+{
+    if (comp(high, low))
+        return 0;
+
+    Node *before, *rest, *range, *after;
+    split_before(root, low, before, rest);
+    split_after(rest, high, range, after);
+
+    root = merge(before, after);
+
+    std::size_t erased = delete_subtree(range);
+    count -= erased;
+
+#ifndef NDEBUG
+    check();
+#endif // !NDEBUG
+
+    return erased;
+}
+
+template <typename T, typename Compare>
+void Treap<T, Compare>::insert_range(const T *values, std::size_t count)
+{
+    if (count == 0)
+        return;
+
+    std::vector<Node *> nodes(count);
+    for (std::size_t i = 0; i < count; i++)
+        nodes[i] = new Node(values[i], engine());
+
+    std::sort(nodes.begin(), nodes.end(),
+              [this](const Node *first, const Node *second) { return comp(first->value, second->value); });
+
+    root = unite(root, build(nodes.data(), count));
+    this->count += count;
+
+#ifndef NDEBUG
+    check();
+#endif // !NDEBUG
+}
+
+template <typename T, typename Compare>
+bool Treap<T, Compare>::empty() const
+{
+    return count == 0;
+}
+
+template <typename T, typename Compare>
+const std::size_t &Treap<T, Compare>::size() const
+{
+    return count;
+}
+
+template <typename T, typename Compare>
+void Treap<T, Compare>::print() const
+{
+    if (!root)
+        return;
+
+    // Print every level of the tree in a separate row
+    std::queue<const Node *> level, next_level;
+    level.push(root);
+
+    while (!level.empty()) {
+        const Node *node = level.front();
+        level.pop();
+
+        std::cout << node->value << " ";
+
+        if (node->lchild)
+            next_level.push(node->lchild);
+        if (node->rchild)
+            next_level.push(node->rchild);
+
+        if (level.empty()) {
+            std::cout << std::endl;
+            std::swap(level, next_level);
+        }
+    }
+}
+
+#ifndef NDEBUG
+template <typename T, typename Compare>
+void Treap<T, Compare>::check() const
+{
+    const T *previous = nullptr;
+
+    if (check_node(root, previous) != count)
+        throw std::runtime_error("Count mismatch");
+}
+
+template <typename T, typename Compare>
+std::size_t Treap<T, Compare>::check_node(const Node *node, const T *&previous) const
+{
+    if (!node)
+        return 0;
+
+    if ((node->lchild && node->lchild->priority > node->priority) ||
+        (node->rchild && node->rchild->priority > node->priority))
+        throw std::runtime_error("Child priority above parent");
+
+    // Values are visited in order, each one must not be ordered before the previous
+    std::size_t nodes = check_node(node->lchild, previous);
+
+    if (previous && comp(node->value, *previous))
+        throw std::runtime_error("Values out of order");
+    previous = &node->value;
+
+    return nodes + check_node(node->rchild, previous) + 1;
+}
+#endif // !NDEBUG
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+
+// Binary search tree kept balanced by random priorities in heap order, expected
+// O(log n) depth. All changes are built from split and merge, so a whole range of
+// values is cut out or joined in with a few O(log n) steps
+template <typename T, typename Compare = std::less<T>>
+class Treap
+{
+public:
+    struct Node
+    {
+        T value;
+        // Parent priority is never lower than priorities of its children
+        std::uint32_t priority;
+
+        Node *lchild = nullptr;
+        Node *rchild = nullptr;
+
+        Node(const T &value, std::uint32_t priority) : value(value), priority(priority)
+        {
+        }
+    };
+
+private:
+    Node *root = nullptr;
+    std::size_t count = 0;
+    Compare comp;
+    std::minstd_rand engine;
+
+    // Values ordered before key go to left, the rest to right
+    void split_before(Node *node, const T &key, Node *&left, Node *&right) const;
+    // Values not ordered after key go to left, the rest to right
+    void split_after(Node *node, const T &key, Node *&left, Node *&right) const;
+    // No value of left may be ordered after a value of right
+    static Node *merge(Node *left, Node *right);
+    // Union of two treaps, values may interleave
+    Node *unite(Node *first, Node *second) const;
+    // Treap of sorted values in O(n)
+    static Node *build(Node **nodes, std::size_t count);
+
+    static std::size_t delete_subtree(Node *node);
+
+    // Assertions
+#ifndef NDEBUG
+    void check() const;
+    // Returns number of nodes in the subtree
+    std::size_t check_node(const Node *node, const T *&previous) const;
+#endif // !NDEBUG
+
+public:
+    Treap(const Compare &comp = Compare());
+    ~Treap();
+
+    Treap(const Treap &) = delete;
+    Treap &operator=(const Treap &) = delete;
+
+    // Returned handle stays valid until the node is removed
+    Node *add(const T &value);
+    bool remove(const T &value);
+    bool contains(const T &value) const;
+
+    // Removes all values within [low, high], returns their number
+    std::size_t erase_range(const T &low, const T &high);
+    // Adds values in any order, they are sorted and joined to the treap at once
+    void insert_range(const T *values, std::size_t count);
+
+    bool empty() const;
+    const std::size_t &size() const;
+    void print() const;
+};
+
+// For template explicit instantiations
+#include "Treap.cpp"
\ No newline at end of file
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <iostream>
+
+#include "TreeMap.hpp"
+
+template <typename K, typename V>
+std::ostream &operator<<(std::ostream &stream, const MapEntry<K, V> &entry)
+{
+    return stream << entry.key << ":" << entry.value;
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+TreeMap<Tree, K, V, Compare>::TreeMap(const Compare &comp) :
+    Base(MapEntryCompare<K, V, Compare>{ comp })
+{
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+template <typename Key, typename... Args>
+std::pair<V *, bool> TreeMap<Tree, K, V, Compare>::emplace_unique(Key &&key, Args &&...args)
+{
+    Node *parent;
+    Node **slot = this->find_slot(key, parent);
+
+    if (*slot)
+        return { &(*slot)->value.value, false };
+
+    Node *node = new Node(std::forward<Key>(key), std::forward<Args>(args)...);
+    this->link_node(node, parent, slot);
+
+    return { &node->value.value, true };
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+V *TreeMap<Tree, K, V, Compare>::find(const K &key)
+{
+    Node *node = this->find_node(key);
+
+    return node ? &node->value.value : nullptr;
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+const V *TreeMap<Tree, K, V, Compare>::find(const K &key) const
+{
+    Node *node = this->find_node(key);
+
+    return node ? &node->value.value : nullptr;
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+bool TreeMap<Tree, K, V, Compare>::contains(const K &key) const
+{
+    return this->find_node(key);
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+bool TreeMap<Tree, K, V, Compare>::remove(const K &key)
+{
+    Node *node = this->find_node(key);
+
+    if (!node)
+        return false;
+
+    this->remove_node(node);
+
+    return true;
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+template <typename Key, typename C, typename>
+V *TreeMap<Tree, K, V, Compare>::find(const Key &key)
+{
+    Node *node = this->find_node(key);
+
+    return node ? &node->value.value : nullptr;
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+template <typename Key, typename C, typename>
+const V *TreeMap<Tree, K, V, Compare>::find(const Key &key) const
+{
+    Node *node = this->find_node(key);
+
+    return node ? &node->value.value : nullptr;
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+template <typename Key, typename C, typename>
+bool TreeMap<Tree, K, V, Compare>::contains(const Key &key) const
+{
+    return this->find_node(key);
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+template <typename Key, typename C, typename>
+bool TreeMap<Tree, K, V, Compare>::remove(const Key &key)
+{
+    Node *node = this->find_node(key);
+
+    if (!node)
+        return false;
+
+    this->remove_node(node);
+
+    return true;
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+std::size_t TreeMap<Tree, K, V, Compare>::contains_many(const K *keys, std::size_t count, bool *results) const
+{
+    std::size_t present = 0;
+
+    this->find_many(keys, count, [&](std::size_t i, Node *node) {
+        results[i] = node;
+        present += node != nullptr;
+    });
+
+    return present;
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+template <typename Key, typename C, typename>
+std::size_t TreeMap<Tree, K, V, Compare>::contains_many(const Key *keys, std::size_t count, bool *results) const
+{
+    std::size_t present = 0;
+
+    this->find_many(keys, count, [&](std::size_t i, Node *node) {
+        results[i] = node;
+        present += node != nullptr;
+    });
+
+    return present;
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+V &TreeMap<Tree, K, V, Compare>::operator[](const K &key)
+{
+    return *emplace_unique(key).first;
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+V &TreeMap<Tree, K, V, Compare>::operator[](K &&key)
+{
+    return *emplace_unique(std::move(key)).first;
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+template <typename... Args>
+std::pair<V *, bool> TreeMap<Tree, K, V, Compare>::try_emplace(const K &key, Args &&...args)
+{
+    return emplace_unique(key, std::forward<Args>(args)...);
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+template <typename... Args>
+std::pair<V *, bool> TreeMap<Tree, K, V, Compare>::try_emplace(K &&key, Args &&...args)
+{
+    return emplace_unique(std::move(key), std::forward<Args>(args)...);
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+template <typename M>
+std::pair<V *, bool> TreeMap<Tree, K, V, Compare>::insert_or_assign(const K &key, M &&value)
+{
+    auto result = emplace_unique(key, std::forward<M>(value));
+
+    if (!result.second)
+        *result.first = std::forward<M>(value);
+
+    return result;
+}
+
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+template <typename M>
+std::pair<V *, bool> TreeMap<Tree, K, V, Compare>::insert_or_assign(K &&key, M &&value)
+{
+    auto result = emplace_unique(std::move(key), std::forward<M>(value));
+
+    if (!result.second)
+        *result.first = std::forward<M>(value);
+
+    return result;
+}
\ No newline at end of file
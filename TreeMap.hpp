@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "RBTree.hpp"
+#include "AVLTree.hpp"
+
+template <typename K, typename V>
+struct MapEntry
+{
+    K key;
+    V value;
+
+    MapEntry() = default;
+
+    // Value is constructed in place from the remaining arguments
+    template <typename Key, typename... Args>
+    MapEntry(Key &&key, Args &&...args) :
+        key(std::forward<Key>(key)), value(std::forward<Args>(args)...)
+    {
+    }
+};
+
+// Orders entries by key only, any type Compare accepts can be used as a key
+template <typename K, typename V, typename Compare>
+struct MapEntryCompare
+{
+    Compare comp;
+
+    bool operator()(const MapEntry<K, V> &first, const MapEntry<K, V> &second) const
+    {
+        return comp(first.key, second.key);
+    }
+
+    template <typename Key>
+    bool operator()(const MapEntry<K, V> &first, const Key &second) const
+    {
+        return comp(first.key, second);
+    }
+
+    template <typename Key>
+    bool operator()(const Key &first, const MapEntry<K, V> &second) const
+    {
+        return comp(first, second.key);
+    }
+};
+
+// Key to value map on top of one of the balanced trees. Values are never
+// copied after insertion, so move-only types can be stored.
+template <template <typename, typename> typename Tree, typename K, typename V, typename Compare>
+class TreeMap : private Tree<MapEntry<K, V>, MapEntryCompare<K, V, Compare>>
+{
+    typedef Tree<MapEntry<K, V>, MapEntryCompare<K, V, Compare>> Base;
+    typedef typename Base::Node Node;
+
+    template <typename Key, typename... Args>
+    std::pair<V *, bool> emplace_unique(Key &&key, Args &&...args);
+
+public:
+    TreeMap(const Compare &comp = Compare());
+
+    // Returns nullptr if key isn't present
+    V *find(const K &key);
+    const V *find(const K &key) const;
+    bool contains(const K &key) const;
+    bool remove(const K &key);
+
+    // Heterogeneous lookup, available if Compare is transparent (std::less<> is)
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    V *find(const Key &key);
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    const V *find(const Key &key) const;
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    bool contains(const Key &key) const;
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    bool remove(const Key &key);
+
+    // Looks keys up in groups whose cache misses overlap, returns number of keys present
+    std::size_t contains_many(const K *keys, std::size_t count, bool *results) const;
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    std::size_t contains_many(const Key *keys, std::size_t count, bool *results) const;
+
+    // Inserts value initialized V if key isn't present
+    V &operator[](const K &key);
+    V &operator[](K &&key);
+
+    // Value is constructed only if key isn't present, returned flag is true if it was inserted
+    template <typename... Args>
+    std::pair<V *, bool> try_emplace(const K &key, Args &&...args);
+    template <typename... Args>
+    std::pair<V *, bool> try_emplace(K &&key, Args &&...args);
+
+    // Value is assigned if key is already present, returned flag is true if it was inserted
+    template <typename M>
+    std::pair<V *, bool> insert_or_assign(const K &key, M &&value);
+    template <typename M>
+    std::pair<V *, bool> insert_or_assign(K &&key, M &&value);
+
+    using Base::print;
+};
+
+template <typename K, typename V, typename Compare = std::less<>>
+using RBMap = TreeMap<RBTree, K, V, Compare>;
+
+template <typename K, typename V, typename Compare = std::less<>>
+using AVLMap = TreeMap<AVLTree, K, V, Compare>;
+
+// For template explicit instantiations
+#include "TreeMap.cpp"
\ No newline at end of file
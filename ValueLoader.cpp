@@ -0,0 +1,195 @@
+#pragma once
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+#include "MappedFile.hpp"
+#include "SpscQueue.hpp"
+#include "TokenReader.hpp"
+#include "ValueLoader.hpp"
+
+inline bool isSeparator(char character)
+{
+    return character == ' ' || character == '\n' || character == '\r' || character == '\t';
+}
+
+inline const char *skipWhitespace(const char *position, const char *end)
+{
+    while (position != end && isSeparator(*position))
+        position++;
+
+    return position;
+}
+
+// Parses one value after optional whitespace, returns position right after it or null when there is none
+template <typename T>
+const char *parseValue(const char *position, const char *end, T &value)
+{
+    position = skipWhitespace(position, end);
+
+    // from_chars does not accept a plus sign
+    if (position != end && *position == '+')
+        position++;
+
+    auto [next, error] = std::from_chars(position, end, value);
+
+    if (error == std::errc::result_out_of_range)
+        throw std::runtime_error("Value out of range!");
+    if (error != std::errc() || (next != end && !isSeparator(*next)))
+        return nullptr;
+
+    return next;
+}
+
+template <typename T>
+std::vector<T> loadValues(const std::string &path, LoadStats *stats)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    MappedFile file(path);
+    const char *position = file.data();
+    const char *end = file.data() + file.size();
+
+    std::size_t count;
+    position = position ? parseValue(position, end, count) : nullptr;
+    if (!position)
+        throw std::runtime_error("File does not start with value count!");
+
+    // Every value takes at least one digit and a separator, reject bad counts before allocating
+    if (count > (std::size_t)(end - position) / 2)
+        throw std::runtime_error("File has fewer values than its header says!");
+
+    std::vector<T> values(count);
+
+    for (std::size_t i = 0; i < count; i++) {
+        const char *next = parseValue(position, end, values[i]);
+
+        if (!next)
+            throw std::runtime_error(skipWhitespace(position, end) == end ?
+                                     "File has fewer values than its header says!" :
+                                     "Invalid value number " + std::to_string(i + 1) + "!");
+        position = next;
+    }
+
+    if (skipWhitespace(position, end) != end)
+        throw std::runtime_error("File has more values than its header says!");
+
+    if (stats) {
+        stats->bytes = file.size();
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return values;
+}
+
+template <typename T, typename F>
+std::size_t streamValues(const std::string &path, F &&consume, LoadStats *stats)
+{
+    const std::size_t batchSize = 4096;
+    const std::size_t queueCapacity = 16;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Opened before the thread starts, so a missing file is reported right away
+    TokenReader reader(path);
+
+    SpscQueue<std::vector<T>> filled(queueCapacity);
+    // Consumed batches go back to the parser to be filled again
+    SpscQueue<std::vector<T>> recycled(queueCapacity);
+
+    std::exception_ptr error;
+    std::atomic<bool> cancelled(false);
+
+    std::thread parser([&] {
+        auto push = [&](std::vector<T> &batch) {
+            while (!filled.try_push(batch)) {
+                if (cancelled.load(std::memory_order_relaxed))
+                    return false;
+                std::this_thread::yield();
+            }
+            return true;
+        };
+
+        std::vector<T> batch;
+
+        try {
+            const char *first, *last;
+            std::size_t count;
+
+            if (!reader.next(first, last) || parseValue(first, last, count) != last)
+                throw std::runtime_error("File does not start with value count!");
+
+            for (std::size_t i = 0; i < count; i++) {
+                if (batch.capacity() == 0 && !recycled.try_pop(batch))
+                    batch.reserve(batchSize);
+
+                if (!reader.next(first, last))
+                    throw std::runtime_error("File has fewer values than its header says!");
+
+                T value;
+                if (parseValue(first, last, value) != last)
+                    throw std::runtime_error("Invalid value number " + std::to_string(i + 1) + "!");
+
+                batch.push_back(value);
+                if (batch.size() == batchSize && !push(batch))
+                    return;
+            }
+
+            if (reader.next(first, last))
+                throw std::runtime_error("File has more values than its header says!");
+
+            if (!batch.empty() && !push(batch))
+                return;
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        // Empty batch marks the end, the parser never sends one otherwise
+        std::vector<T> end;
+        push(end);
+    });
+
+    std::size_t consumed = 0;
+    std::vector<T> batch;
+
+    try {
+        while (true) {
+            if (!filled.try_pop(batch)) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (batch.empty())
+                break;
+
+            for (const T &value : batch)
+                consume(value);
+            consumed += batch.size();
+
+            batch.clear();
+            recycled.try_push(batch);
+        }
+    }
+    catch (...) {
+        cancelled = true;
+        parser.join();
+        throw;
+    }
+
+    parser.join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    if (stats) {
+        stats->bytes = reader.bytes();
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return consumed;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct LoadStats
+{
+    std::size_t bytes = 0;
+    double seconds = 0;
+
+    double megabytesPerSecond() const
+    {
+        return seconds > 0 ? bytes / seconds / 1'000'000 : 0;
+    }
+};
+
+// Loads integers from a file that starts with their count, values are separated by whitespace.
+// Throws std::runtime_error when the count does not match the values in the file.
+template <typename T>
+std::vector<T> loadValues(const std::string &path, LoadStats *stats = nullptr);
+
+// Same format parsed on a separate thread, values are passed to consume(value) in file order.
+// Batches go through a lock-free queue, so memory use does not depend on the file size.
+// Returns number of consumed values, on error the values before it are already consumed.
+template <typename T, typename F>
+std::size_t streamValues(const std::string &path, F &&consume, LoadStats *stats = nullptr);
+
+// For template explicit instantiations
+#include "ValueLoader.cpp"
\ No newline at end of file
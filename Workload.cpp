@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include "Workload.hpp"
+
+template <typename Enum>
+Enum parseWorkloadName(const std::string &name)
+{
+    for (int value = 0;; value++) {
+        std::string candidate = workloadName((Enum)value);
+
+        if (candidate.empty())
+            throw std::invalid_argument("Unknown workload name: " + name);
+        if (candidate == name)
+            return (Enum)value;
+    }
+}
+
+template <typename T>
+Workload<T>::Workload(unsigned seed) : generator(seed)
+{
+}
+
+template <typename T>
+std::default_random_engine &Workload<T>::engine()
+{
+    return generator;
+}
+
+template <typename T>
+std::size_t Workload<T>::zipfRank(std::size_t count)
+{
+    if (zipfCdf.size() != count) {
+        zipfCdf.resize(count);
+
+        double sum = 0;
+        for (std::size_t rank = 0; rank < count; rank++) {
+            sum += 1 / std::pow(rank + 1, zipfExponent);
+            zipfCdf[rank] = sum;
+        }
+        for (auto &probability : zipfCdf)
+            probability /= sum;
+    }
+
+    std::uniform_real_distribution<double> distribution(0, 1);
+    auto found = std::lower_bound(zipfCdf.begin(), zipfCdf.end(), distribution(generator));
+
+    return std::min<std::size_t>(found - zipfCdf.begin(), count - 1);
+}
+
+template <typename T>
+std::vector<T> Workload<T>::distinctKeys(std::size_t count, const T &min, const T &max)
+{
+    if ((unsigned long long)max - (unsigned long long)min < count - 1)
+        throw std::runtime_error("Key range too small!");
+
+    std::uniform_int_distribution<T> distribution(min, max);
+    std::vector<T> keys(count);
+
+    for (auto &key : keys)
+        key = distribution(generator);
+
+    // std::unique needs sorted data, redraw duplicates until none are left
+    std::sort(keys.begin(), keys.end());
+    auto last = std::unique(keys.begin(), keys.end());
+
+    while (last != keys.end()) {
+        for (auto it = last; it != keys.end(); it++)
+            *it = distribution(generator);
+
+        std::sort(last, keys.end());
+        std::inplace_merge(keys.begin(), last, keys.end());
+        last = std::unique(keys.begin(), keys.end());
+    }
+
+    std::shuffle(keys.begin(), keys.end(), generator);
+
+    return keys;
+}
+
+template <typename T>
+std::vector<T> Workload<T>::keys(KeyDistribution distribution, std::size_t count, const T &min, const T &max)
+{
+    if (count == 0)
+        return {};
+
+    switch (distribution) {
+    case KeyDistribution::UNIFORM:
+        return distinctKeys(count, min, max);
+
+    case KeyDistribution::SORTED: {
+        auto keys = distinctKeys(count, min, max);
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+    case KeyDistribution::REVERSE: {
+        auto keys = distinctKeys(count, min, max);
+        std::sort(keys.rbegin(), keys.rend());
+        return keys;
+    }
+
+    case KeyDistribution::NEARLY_SORTED: {
+        auto keys = distinctKeys(count, min, max);
+        std::sort(keys.begin(), keys.end());
+
+        std::uniform_int_distribution<std::size_t> position(0, count - 1);
+        std::uniform_int_distribution<std::size_t> offset(1, 8);
+
+        for (std::size_t i = 0; i < std::max<std::size_t>(count / 100, 1); i++) {
+            std::size_t from = position(generator);
+            std::swap(keys[from], keys[std::min(from + offset(generator), count - 1)]);
+        }
+        return keys;
+    }
+
+    case KeyDistribution::ZIPF: {
+        auto universe = distinctKeys(count, min, max);
+        std::vector<T> keys(count);
+
+        // Universe is in random order, so hot keys are spread over the range
+        for (auto &key : keys)
+            key = universe[zipfRank(count)];
+        return keys;
+    }
+
+    case KeyDistribution::CLUSTERED: {
+        const std::size_t clustersCount = std::min<std::size_t>(count, 16);
+        // Clusters are about 4 times wider than the number of keys they hold
+        const unsigned long long width = std::min<unsigned long long>(
+            4 * (count / clustersCount + 1), ((unsigned long long)max - (unsigned long long)min) / clustersCount);
+
+        auto starts = distinctKeys(clustersCount, min, (T)(max - (T)width));
+        std::uniform_int_distribution<std::size_t> cluster(0, clustersCount - 1);
+        std::uniform_int_distribution<unsigned long long> offset(0, width);
+        std::vector<T> keys(count);
+
+        for (auto &key : keys)
+            key = (T)(starts[cluster(generator)] + offset(generator));
+        return keys;
+    }
+
+    case KeyDistribution::DUPLICATES: {
+        auto universe = distinctKeys(std::max<std::size_t>(count / 100, 1), min, max);
+        std::uniform_int_distribution<std::size_t> pick(0, universe.size() - 1);
+        std::vector<T> keys(count);
+
+        for (auto &key : keys)
+            key = universe[pick(generator)];
+        return keys;
+    }
+    }
+
+    throw std::runtime_error("Unknown key distribution!");
+}
+
+template <typename T>
+std::vector<std::size_t> Workload<T>::accessOrder(AccessPattern pattern, const std::vector<T> &keys, bool distinct)
+{
+    std::vector<std::size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    switch (pattern) {
+    case AccessPattern::RANDOM:
+        std::shuffle(order.begin(), order.end(), generator);
+        break;
+
+    case AccessPattern::INSERTION:
+        break;
+
+    case AccessPattern::SORTED:
+        std::stable_sort(order.begin(), order.end(),
+                         [&](std::size_t first, std::size_t second) { return keys[first] < keys[second]; });
+        break;
+
+    case AccessPattern::ZIPF: {
+        // Random hotness rank for every index
+        std::vector<std::size_t> hottest(order);
+        std::shuffle(hottest.begin(), hottest.end(), generator);
+
+        if (!distinct) {
+            for (auto &index : order)
+                index = hottest[zipfRank(keys.size())];
+            break;
+        }
+
+        // Weighted sampling without replacement (Efraimidis-Spirakis),
+        // hot keys are likely to come first
+        std::uniform_real_distribution<double> distribution(0, 1);
+        std::vector<std::pair<double, std::size_t>> weighted(keys.size());
+
+        for (std::size_t rank = 0; rank < keys.size(); rank++) {
+            double weight = 1 / std::pow(rank + 1, zipfExponent);
+            weighted[rank] = { std::log(1 - distribution(generator)) / weight, hottest[rank] };
+        }
+
+        std::sort(weighted.begin(), weighted.end(), std::greater<>());
+        for (std::size_t i = 0; i < keys.size(); i++)
+            order[i] = weighted[i].second;
+        break;
+    }
+    }
+
+    return order;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+enum class KeyDistribution
+{
+    // Distinct keys drawn uniformly from the range
+    UNIFORM,
+    SORTED,
+    REVERSE,
+    // Sorted with about 1% of keys moved by a few positions
+    NEARLY_SORTED,
+    // Few hot keys repeated many times
+    ZIPF,
+    // Dense groups of keys around a few random centers
+    CLUSTERED,
+    // About 100 copies of every key
+    DUPLICATES
+};
+
+enum class AccessPattern
+{
+    RANDOM,
+    // Same order as keys were added
+    INSERTION,
+    // Ascending key order
+    SORTED,
+    // Hot keys are accessed first and most often
+    ZIPF
+};
+
+inline const char *workloadName(KeyDistribution distribution)
+{
+    switch (distribution) {
+    case KeyDistribution::UNIFORM:
+        return "uniform";
+    case KeyDistribution::SORTED:
+        return "sorted";
+    case KeyDistribution::REVERSE:
+        return "reverse";
+    case KeyDistribution::NEARLY_SORTED:
+        return "nearly_sorted";
+    case KeyDistribution::ZIPF:
+        return "zipf";
+    case KeyDistribution::CLUSTERED:
+        return "clustered";
+    case KeyDistribution::DUPLICATES:
+        return "duplicates";
+    }
+
+    return "";
+}
+
+inline const char *workloadName(AccessPattern pattern)
+{
+    switch (pattern) {
+    case AccessPattern::RANDOM:
+        return "random";
+    case AccessPattern::INSERTION:
+        return "insertion";
+    case AccessPattern::SORTED:
+        return "sorted";
+    case AccessPattern::ZIPF:
+        return "zipf";
+    }
+
+    return "";
+}
+
+// Throws if name does not match any value of Enum
+template <typename Enum>
+Enum parseWorkloadName(const std::string &name);
+
+// Generates benchmark keys and orders in which they are accessed
+template <typename T>
+class Workload
+{
+    std::default_random_engine generator;
+
+    // Exponent used by YCSB
+    const double zipfExponent = 0.99;
+    // Cumulative distribution of the last used Zipf size
+    std::vector<double> zipfCdf;
+
+    std::size_t zipfRank(std::size_t count);
+    std::vector<T> distinctKeys(std::size_t count, const T &min, const T &max);
+
+public:
+    Workload(unsigned seed = std::default_random_engine::default_seed);
+
+    // Engine behind all draws, callers may use it for their own random values
+    std::default_random_engine &engine();
+
+    std::vector<T> keys(KeyDistribution distribution, std::size_t count, const T &min, const T &max);
+
+    // Indices of keys in the order they are accessed
+    // Distinct order contains every index exactly once, otherwise hot keys may repeat
+    std::vector<std::size_t> accessOrder(AccessPattern pattern, const std::vector<T> &keys, bool distinct);
+};
+
+// For template explicit instantiations
+#include "Workload.cpp"
\ No newline at end of file